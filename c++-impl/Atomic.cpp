@@ -0,0 +1,95 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifdef WIN32
+# include <windows.h>
+#endif
+#include <gleem/Atomic.h>
+
+GLEEM_USE_NAMESPACE
+
+long
+Atomic::fetchAndAdd(volatile long *val, long delta)
+{
+#if defined(WIN32)
+  return InterlockedExchangeAdd((LONG volatile *) val, delta);
+#elif defined(__GNUC__)
+  return __sync_fetch_and_add(val, delta);
+#elif defined(__sgi)
+  return __fetch_and_add(val, delta);
+#else
+  long prev = *val;
+  *val = prev + delta;
+  return prev;
+#endif
+}
+
+bool
+Atomic::compareAndSwap(volatile long *val, long oldVal, long newVal)
+{
+#if defined(WIN32)
+  return (InterlockedCompareExchange((LONG volatile *) val,
+				     newVal, oldVal) == oldVal);
+#elif defined(__GNUC__)
+  return __sync_bool_compare_and_swap(val, oldVal, newVal);
+#elif defined(__sgi)
+  return (__compare_and_swap(val, oldVal, newVal) != 0);
+#else
+  if (*val != oldVal)
+    return false;
+  *val = newVal;
+  return true;
+#endif
+}
+
+bool
+Atomic::compareAndSwapPtr(void * volatile *ptr, void *oldVal, void *newVal)
+{
+#if defined(WIN32)
+  return (InterlockedCompareExchangePointer(ptr, newVal, oldVal) == oldVal);
+#elif defined(__GNUC__)
+  return __sync_bool_compare_and_swap(ptr, oldVal, newVal);
+#elif defined(__sgi)
+  // Pointers are the same size as longs in both the n32 and 64-bit
+  // ABIs
+  return (__compare_and_swap((long *) ptr, (long) oldVal, (long) newVal)
+	  != 0);
+#else
+  if (*ptr != oldVal)
+    return false;
+  *ptr = newVal;
+  return true;
+#endif
+}
+
+void *
+Atomic::loadPtr(void * volatile *ptr)
+{
+  void *val = *ptr;
+  memoryBarrier();
+  return val;
+}
+
+long
+Atomic::load(volatile long *val)
+{
+  long result = *val;
+  memoryBarrier();
+  return result;
+}
+
+void
+Atomic::memoryBarrier()
+{
+#if defined(WIN32)
+  LONG dummy = 0;
+  InterlockedExchange(&dummy, 1);
+#elif defined(__GNUC__)
+  __sync_synchronize();
+#elif defined(__sgi)
+  __synchronize();
+#endif
+}
@@ -0,0 +1,55 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_ATOMIC_H
+#define _GLEEM_ATOMIC_H
+
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+
+GLEEM_ENTER_NAMESPACE
+
+/** Atomic operations on machine words, for the few places in gleem
+    which may be entered from more than one thread. Implemented with
+    the Interlocked functions on Win32, the __sync builtins on gcc and
+    the MIPSpro synchronization intrinsics on IRIX. On other platforms
+    the operations are not atomic and gleem must only be used from a
+    single thread. All operations act as full memory barriers. */
+
+GLEEM_INTERNAL class GLEEMDLL Atomic
+{
+public:
+  /** Adds delta to *val and returns the value *val had before the
+      addition. */
+  static long fetchAndAdd(volatile long *val, long delta);
+
+  /** If *val equals oldVal, sets it to newVal and returns true;
+      otherwise leaves it alone and returns false. */
+  static bool compareAndSwap(volatile long *val, long oldVal, long newVal);
+
+  /** Pointer version of compareAndSwap() */
+  static bool compareAndSwapPtr(void * volatile *ptr,
+				void *oldVal, void *newVal);
+
+  /** Returns *ptr. Accesses after the call, including those through
+      the returned pointer, see everything written before the store
+      of the value read (when that store was made with
+      compareAndSwapPtr()). */
+  static void *loadPtr(void * volatile *ptr);
+
+  /** long version of loadPtr(), for values written with
+      fetchAndAdd() or compareAndSwap() */
+  static long load(volatile long *val);
+
+  /** Orders all memory accesses before the call before all of those
+      after it */
+  static void memoryBarrier();
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_ATOMIC_H
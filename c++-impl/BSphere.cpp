@@ -69,50 +69,85 @@ BSphere::getValue(GleemV3f &center) const
 void
 BSphere::extendBy(const BSphere &arg)
 {
-  if ((radius == 0.0f) || (arg.radius == 0.0f))
+  if (arg.radius == 0.0f)
     return;
-  // FIXME: This algorithm is a quick hack -- minimum bounding
-  // sphere of a set of other spheres is a well studied problem, but
-  // not by me
+  if (radius == 0.0f)
+    {
+      setValue(arg.center, arg.radius);
+      return;
+    }
   GleemV3f diff = arg.center - center;
-  if (diff.lengthSquared() == 0.0f)
-  {
-    setRadius(GLEEM_MAX2(radius, arg.radius));
+  float dist = diff.length();
+  // One sphere may already contain the other
+  if (dist + arg.radius <= radius)
     return;
-  }
-  GleemV3f intPt[4];
-  float t[4];
-  int numIntersections;
-  bool result = intersectRay(center, diff, numIntersections,
-			     intPt[0], t[0], intPt[1], t[1]);
-  assert(result && (numIntersections == 2));
-  result = intersectRay(center, diff, numIntersections,
-			intPt[2], t[2], intPt[3], t[3]);
-  assert(result && (numIntersections == 2));
-  GleemV3f minIntPt = intPt[0], maxIntPt = intPt[0];
-  float minT = t[0], maxT = t[0];
-  // Find minimum and maximum t values, take associated intersection
-  // points, find midpoint and half length of line segment -->
-  // center and radius.
-  for (int i = 0; i < 4; i++)
-  {
-    if (t[i] < minT)
+  if (dist + radius <= arg.radius)
     {
-      minIntPt = intPt[i];
-      minT = t[i];
+      setValue(arg.center, arg.radius);
+      return;
     }
-    else if (t[i] > maxT)
+  // Otherwise the new sphere spans the two far sides of the
+  // originals along the line between their centers. dist can not be
+  // zero here since neither sphere contains the other.
+  float newRadius = 0.5f * (dist + radius + arg.radius);
+  GleemV3f::addScaled(center, (newRadius - radius) / dist, diff, center);
+  setRadius(newRadius);
+}
+
+void
+BSphere::makeFromPoints(const GleemV3f *points, int numPoints)
+{
+  if (numPoints <= 0)
     {
-      maxIntPt = intPt[i];
-      maxT = t[i];
+      makeEmpty();
+      return;
     }
-  }
-  // Compute the average -- this is the new center
-  GleemV3f::add(minIntPt, maxIntPt, center);
+  // Center on the midpoint of the axis-aligned bounds, then take the
+  // farthest point as the radius
+  GleemV3f minPt = points[0], maxPt = points[0];
+  int i, j;
+  for (i = 1; i < numPoints; i++)
+    {
+      const GleemV3f &pt = points[i];
+      for (j = 0; j < 3; j++)
+	{
+	  if (pt[j] < minPt[j])
+	    minPt[j] = pt[j];
+	  else if (pt[j] > maxPt[j])
+	    maxPt[j] = pt[j];
+	}
+    }
+  GleemV3f::add(minPt, maxPt, center);
   GleemV3f::scale(center, 0.5f, center);
-  // Compute half the length -- this is the radius
-  GleemV3f newDiff = minIntPt - maxIntPt;
-  setRadius(0.5f * newDiff.length());
+  float maxDistSq = 0.0f;
+  GleemV3f diff;
+  for (i = 0; i < numPoints; i++)
+    {
+      GleemV3f::sub(points[i], center, diff);
+      float distSq = diff.lengthSquared();
+      if (distSq > maxDistSq)
+	maxDistSq = distSq;
+    }
+  setRadius(sqrtf(maxDistSq));
+}
+
+bool
+BSphere::hitByRay(const GleemV3f &rayStart,
+		  const GleemV3f &rayDirection) const
+{
+  GleemV3f diff;
+  GleemV3f::sub(center, rayStart, diff);
+  float c = diff.lengthSquared() - radSq;
+  if (c <= 0.0f)
+    // Ray starts inside sphere
+    return true;
+  float b = diff.dot(rayDirection);
+  if (b < 0.0f)
+    // Sphere is behind the ray
+    return false;
+  // Squared distance from center to ray, scaled by the squared
+  // length of the direction, compared against the squared radius
+  return (b * b >= c * rayDirection.lengthSquared());
 }
 
 bool
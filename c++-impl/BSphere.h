@@ -39,9 +39,21 @@ public:
   float getValue(GleemV3f &center) const;
 
   /** Mutate this sphere to encompass both itself and the
-      argument. Ignores zero-size arguments. */
+      argument. Ignores zero-size arguments. If this sphere is of zero
+      size it becomes a copy of the argument. */
   void extendBy(const BSphere &arg);
 
+  /** Set this sphere to one enclosing all of the given points. The
+      result is not necessarily the minimal bounding sphere. */
+  void makeFromPoints(const GleemV3f *points, int numPoints);
+
+  /** Cheap one-sided ray test which computes no intersection points.
+      Returns true if the ray starts inside the sphere or passes
+      through it ahead of its start point. Intended for trivial
+      rejection before more expensive intersection tests. */
+  bool hitByRay(const GleemV3f &rayStart,
+		const GleemV3f &rayDirection) const;
+
   /** Intersect a ray with the sphere. Returns true if intersection
       occurred, false otherwise. This is a one-sided ray cast. Returns
       number of intersections which occurred. If one occurred then
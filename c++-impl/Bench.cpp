@@ -0,0 +1,1114 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+// Headless benchmark for the picking, dragging and recalc paths.
+// Builds synthetic scenes without opening a window, drives the
+// ManipManager's event handlers directly and prints one line per
+// benchmark of the form
+//
+//   bench=<scene>.<op> n=<manips> ops=<count> ns_per_op=<x> allocs_per_op=<y>
+//
+// so that results can be collected and compared between builds. The
+// linear algebra kernels are timed too, under the group linalg_sse or
+// linalg_scalar depending on how gleem was built.
+//
+// Usage: bench [-n numManips] [-depth treeDepth] [-iters iterations]
+//              [-only substring] [-trace traceFile] [-noarenas]
+//              [-notables] [-nolod] [-targets numTargets]
+//              [-targetthreads n]
+//        bench -replay eventLog [-trace traceFile]
+//
+// -noarenas makes the manipulators allocate their parts individually
+// on the heap instead of from per-manipulator arenas, and -notables
+// makes the manipulators pick, render and transform by walking their
+// ManipPart trees instead of through their compiled part tables, for
+// comparing the two. -nolod draws and picks every manipulator in full
+// however small it is on screen.
+//
+// The targets group times moving -targets objects (default 5000) with
+// one HandleBoxManip, first the way a motion callback per object
+// would, rebuilding each object's matrix from the manipulator's
+// state, then through Manip::setTargets(), with -targetthreads extra
+// threads helping (see ManipManager::setTargetThreads()).
+//
+// The second form replays an event log recorded from TestHandleBox
+// (run it with GLEEM_EVENT_LOG set to a file name) into the same
+// scene, prints the time taken per event type, and then prints the
+// manipulator's final state with each float as its bit pattern in
+// hex; two builds which replay the same log must print identical
+// state lines.
+//
+// If gleem was compiled with GLEEM_ENABLE_TRACE, -trace writes the
+// most recent trace events to the named file in the Chrome trace
+// format when the run finishes.
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#ifdef WIN32
+# include <windows.h>
+#endif
+#include <GL/glut.h>
+#include <gleem/Clock.h>
+#include <gleem/EventLog.h>
+#include <gleem/Trace.h>
+#include <gleem/ManipManager.h>
+#include <gleem/Manip.h>
+#include <gleem/HandleBoxManip.h>
+#include <gleem/Translate1Manip.h>
+#include <gleem/Translate2Manip.h>
+#include <gleem/ManipPartGroup.h>
+#include <gleem/ManipPartTransform.h>
+#include <gleem/ManipPartCube.h>
+#include <gleem/ManipPartTable.h>
+#include <gleem/Plane.h>
+#include <gleem/BSphere.h>
+
+GLEEM_USE_NAMESPACE
+
+//----------------------------------------------------------------------
+// Allocation counting
+//
+
+static unsigned long numAllocs = 0;
+
+void *
+operator new(size_t size)
+{
+  ++numAllocs;
+  void *p = malloc(size > 0 ? size : 1);
+  if (p == NULL)
+    {
+      fprintf(stderr, "bench: out of memory\n");
+      abort();
+    }
+  return p;
+}
+
+void
+operator delete(void *p)
+{
+  if (p != NULL)
+    free(p);
+}
+
+void *
+operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void
+operator delete[](void *p)
+{
+  operator delete(p);
+}
+
+//----------------------------------------------------------------------
+// A manipulator made of a deep tree of ManipPartGroups with cubes at
+// the leaves. Drags in the plane facing the camera.
+//
+
+class GroupTreeManip : public Manip
+{
+public:
+  GroupTreeManip(int depth);
+  virtual ~GroupTreeManip();
+
+  void setTranslation(const GleemV3f &translation);
+  const GleemV3f &getTranslation() const;
+
+  virtual void render();
+  virtual void intersectRay(const GleemV3f &rayStart,
+			    const GleemV3f &rayDirection,
+			    vector<HitPoint> &results);
+  virtual void highlight(const HitPoint &hit);
+  virtual void clearHighlight();
+  virtual void makeActive(const HitPoint &hit);
+  virtual void drag(const GleemV3f &rayStart,
+		    const GleemV3f &rayDirection);
+  virtual void makeInactive();
+  virtual bool getBoundingSphere(BSphere &bsph);
+
+private:
+  ManipPart *makeTree(int depth, int &leafIndex, int side);
+  void recalc();
+
+  ManipPartGroup *root;
+  GleemV3f translation;
+  Plane dragPlane;
+  GleemV3f dragOffset;
+};
+
+GroupTreeManip::GroupTreeManip(int depth)
+{
+  int numLeaves = 1 << depth;
+  int side = (int) ceil(sqrt((double) numLeaves));
+  int leafIndex = 0;
+  root = new ManipPartGroup(this);
+  root->addPart(makeTree(depth, leafIndex, side));
+  getPartTable()->addPickRoot(root);
+  translation.setValue(0, 0, 0);
+  recalc();
+}
+
+GroupTreeManip::~GroupTreeManip()
+{
+  delete root;
+}
+
+void
+GroupTreeManip::setTranslation(const GleemV3f &translation)
+{
+  this->translation = translation;
+  recalc();
+}
+
+const GleemV3f &
+GroupTreeManip::getTranslation() const
+{
+  return translation;
+}
+
+void
+GroupTreeManip::render()
+{
+  ManipPartTable *table = getActivePartTable();
+  if (table != NULL)
+    table->render();
+  else
+    root->render();
+}
+
+void
+GroupTreeManip::intersectRay(const GleemV3f &rayStart,
+			     const GleemV3f &rayDirection,
+			     vector<HitPoint> &results)
+{
+  root->intersectRay(rayStart, rayDirection, results);
+}
+
+void
+GroupTreeManip::highlight(const HitPoint &hit)
+{
+  hit.manipPart->highlight();
+}
+
+void
+GroupTreeManip::clearHighlight()
+{
+  root->clearHighlight();
+}
+
+void
+GroupTreeManip::makeActive(const HitPoint &hit)
+{
+  hit.manipPart->highlight();
+  dragPlane.setNormal(GleemV3f(0, 0, 1));
+  dragPlane.setPoint(hit.intPt);
+  GleemV3f::sub(translation, hit.intPt, dragOffset);
+}
+
+void
+GroupTreeManip::drag(const GleemV3f &rayStart,
+		     const GleemV3f &rayDirection)
+{
+  GleemV3f intPt;
+  float t;
+  if (dragPlane.intersectRay(rayStart, rayDirection, intPt, t) == false)
+    return;
+  translation = intPt + dragOffset;
+  recalc();
+  Manip::drag(rayStart, rayDirection);
+}
+
+void
+GroupTreeManip::makeInactive()
+{
+  root->clearHighlight();
+}
+
+bool
+GroupTreeManip::getBoundingSphere(BSphere &bsph)
+{
+  ManipPartTable *table = getActivePartTable();
+  if (table != NULL)
+    return table->getBoundingSphere(bsph);
+  return root->getBoundingSphere(bsph);
+}
+
+ManipPart *
+GroupTreeManip::makeTree(int depth, int &leafIndex, int side)
+{
+  if (depth == 0)
+    {
+      // Lay the leaves out on a side x side grid covering [-1, 1] in x
+      // and y
+      float cellSize = 2.0f / (float) side;
+      int row = leafIndex / side;
+      int col = leafIndex % side;
+      ++leafIndex;
+      GleemMat4f offset;
+      offset.makeIdent();
+      offset[0][0] = offset[1][1] = offset[2][2] = 0.4f * cellSize;
+      offset.setTranslation(GleemV3f(-1.0f + (col + 0.5f) * cellSize,
+				     -1.0f + (row + 0.5f) * cellSize,
+				     0));
+      ManipPartTransform *xform = new ManipPartTransform(this);
+      xform->setOffsetTransform(offset);
+      xform->addPart(new ManipPartCube(this));
+      return xform;
+    }
+  ManipPartGroup *group = new ManipPartGroup(this);
+  group->addPart(makeTree(depth - 1, leafIndex, side));
+  group->addPart(makeTree(depth - 1, leafIndex, side));
+  return group;
+}
+
+void
+GroupTreeManip::recalc()
+{
+  GleemMat4f xform;
+  xform.makeIdent();
+  xform.setTranslation(translation);
+  ManipPartTable *table = getActivePartTable();
+  if (table != NULL)
+    table->setTransform(xform);
+  else
+    root->setTransform(xform);
+}
+
+//----------------------------------------------------------------------
+// Scenes
+//
+
+/** A grid of manipulators centered on the origin in the z = 0
+    plane. */
+
+class BenchScene
+{
+public:
+  BenchScene(const char *name) : name(name) {}
+  virtual ~BenchScene() {}
+
+  const char *getName() const { return name; }
+  virtual void create(int numManips) = 0;
+  virtual void destroy() = 0;
+  virtual int getNumManips() const = 0;
+  virtual void setTranslation(int i, const GleemV3f &translation) = 0;
+  virtual const GleemV3f &getTranslation(int i) const = 0;
+
+  /** Distance between adjacent grid cells */
+  virtual float getSpacing() const { return 4.0f; }
+
+  /** Computes the grid location of the ith of numManips
+      manipulators */
+  void getGridLocation(int i, int numManips, GleemV3f &dest) const;
+
+  /** Half of the width of the grid */
+  float getHalfExtent(int numManips) const;
+
+private:
+  const char *name;
+};
+
+void
+BenchScene::getGridLocation(int i, int numManips, GleemV3f &dest) const
+{
+  int side = (int) ceil(sqrt((double) numManips));
+  float start = -0.5f * (float) (side - 1) * getSpacing();
+  dest.setValue(start + (float) (i % side) * getSpacing(),
+		start + (float) (i / side) * getSpacing(),
+		0);
+}
+
+float
+BenchScene::getHalfExtent(int numManips) const
+{
+  int side = (int) ceil(sqrt((double) numManips));
+  return 0.5f * (float) side * getSpacing();
+}
+
+template <class T>
+class GridScene : public BenchScene
+{
+public:
+  GridScene(const char *name) : BenchScene(name) {}
+
+  virtual void create(int numManips)
+  {
+    for (int i = 0; i < numManips; i++)
+      {
+	T *manip = new T();
+	setUp(manip);
+	GleemV3f loc;
+	getGridLocation(i, numManips, loc);
+	manip->setTranslation(loc);
+	manips.push_back(manip);
+      }
+  }
+
+  virtual void destroy()
+  {
+    for (int i = 0; i < manips.size(); i++)
+      delete manips[i];
+    manips.erase(manips.begin(), manips.end());
+  }
+
+  virtual int getNumManips() const
+  {
+    return manips.size();
+  }
+
+  virtual void setTranslation(int i, const GleemV3f &translation)
+  {
+    manips[i]->setTranslation(translation);
+  }
+
+  virtual const GleemV3f &getTranslation(int i) const
+  {
+    return manips[i]->getTranslation();
+  }
+
+protected:
+  virtual void setUp(T *manip) {}
+
+private:
+  vector<T *> manips;
+};
+
+class Translate2Scene : public GridScene<Translate2Manip>
+{
+public:
+  Translate2Scene() : GridScene<Translate2Manip>("translate2") {}
+
+protected:
+  virtual void setUp(Translate2Manip *manip)
+  {
+    // Face the camera
+    manip->setNormal(GleemV3f(0, 0, 1));
+  }
+};
+
+class GroupTreeScene : public BenchScene
+{
+public:
+  GroupTreeScene(int depth) : BenchScene("grouptree"), depth(depth) {}
+
+  virtual void create(int numManips)
+  {
+    for (int i = 0; i < numManips; i++)
+      {
+	GroupTreeManip *manip = new GroupTreeManip(depth);
+	GleemV3f loc;
+	getGridLocation(i, numManips, loc);
+	manip->setTranslation(loc);
+	manips.push_back(manip);
+      }
+  }
+
+  virtual void destroy()
+  {
+    for (int i = 0; i < manips.size(); i++)
+      delete manips[i];
+    manips.erase(manips.begin(), manips.end());
+  }
+
+  virtual int getNumManips() const
+  {
+    return manips.size();
+  }
+
+  virtual void setTranslation(int i, const GleemV3f &translation)
+  {
+    manips[i]->setTranslation(translation);
+  }
+
+  virtual const GleemV3f &getTranslation(int i) const
+  {
+    return manips[i]->getTranslation();
+  }
+
+private:
+  int depth;
+  vector<GroupTreeManip *> manips;
+};
+
+//----------------------------------------------------------------------
+// Harness
+//
+
+static const int windowID = 1;
+static const int windowSize = 512;
+static const float vertFOV = (float) (M_PI / 8.0);
+static const char *onlyBench = NULL;
+
+static CameraParameters params;
+
+/** Places the camera on the +z axis far enough away to see the whole
+    grid */
+static void
+setUpCamera(BenchScene &scene, int numManips)
+{
+  float dist = 1.1f * scene.getHalfExtent(numManips) / tan(vertFOV) + 2.0f;
+  params.position.setValue(0, 0, dist);
+  params.forwardDirection.setValue(0, 0, -1);
+  params.upDirection.setValue(0, 1, 0);
+  params.vertFOV = vertFOV;
+  params.imagePlaneAspectRatio = 1;
+  params.xSize = windowSize;
+  params.ySize = windowSize;
+  ManipManager::getManipManager()->updateCameraParameters(windowID, params);
+}
+
+/** Projects a point in the z = 0 plane to window coordinates (origin
+    at upper left, as in GLUT) */
+static void
+projectToWindow(const GleemV3f &pt, int &x, int &y)
+{
+  float dist = params.position[2] - pt[2];
+  float t = tan(params.vertFOV);
+  float nx = pt[0] / (dist * t * params.imagePlaneAspectRatio);
+  float ny = pt[1] / (dist * t);
+  x = (int) ((nx + 1.0f) * 0.5f * (float) params.xSize);
+  y = (int) ((1.0f - ny) * 0.5f * (float) params.ySize);
+}
+
+/** Measures elapsed time and allocations between construction and
+    report() */
+class BenchTimer
+{
+public:
+  BenchTimer() { start(); }
+
+  void start()
+  {
+    startAllocs = numAllocs;
+    startTime = Clock::nanoTime();
+  }
+
+  void report(const char *group, const char *op, int numManips,
+	      unsigned long ops)
+  {
+    GleemInt64 elapsed = Clock::nanoTime() - startTime;
+    unsigned long allocs = numAllocs - startAllocs;
+    if (ops == 0)
+      ops = 1;
+    printf("bench=%s.%s n=%d ops=%lu ns_per_op=%.1f allocs_per_op=%.3f\n",
+	   group, op, numManips, ops,
+	   (double) elapsed / (double) ops,
+	   (double) allocs / (double) ops);
+    fflush(stdout);
+  }
+
+private:
+  GleemInt64 startTime;
+  unsigned long startAllocs;
+};
+
+static bool
+enabled(const char *group, const char *op)
+{
+  if (onlyBench == NULL)
+    return true;
+  char buf[256];
+  sprintf(buf, "%.100s.%.100s", group, op);
+  return (strstr(buf, onlyBench) != NULL);
+}
+
+/** Hover: passive motion events swept over a raster covering the
+    window */
+static void
+benchHover(BenchScene &scene, int numManips, int iters)
+{
+  if (!enabled(scene.getName(), "hover"))
+    return;
+  ManipManager *manager = ManipManager::getManipManager();
+  const int step = 8;
+  unsigned long ops = 0;
+  BenchTimer timer;
+  for (int iter = 0; iter < iters; iter++)
+    for (int y = 0; y < windowSize; y += step)
+      for (int x = 0; x < windowSize; x += step)
+	{
+	  manager->passiveMotionMethod(windowID, x, y);
+	  ++ops;
+	}
+  timer.report(scene.getName(), "hover", numManips, ops);
+}
+
+/** Click: mouse down and up over the center of each manipulator in
+    turn */
+static void
+benchClick(BenchScene &scene, int numManips, int iters)
+{
+  if (!enabled(scene.getName(), "click"))
+    return;
+  ManipManager *manager = ManipManager::getManipManager();
+  unsigned long ops = 0;
+  BenchTimer timer;
+  for (int iter = 0; iter < iters; iter++)
+    for (int i = 0; i < scene.getNumManips(); i++)
+      {
+	int x, y;
+	projectToWindow(scene.getTranslation(i), x, y);
+	manager->mouseMethod(windowID, GLUT_LEFT_BUTTON, GLUT_DOWN, x, y);
+	manager->mouseMethod(windowID, GLUT_LEFT_BUTTON, GLUT_UP, x, y);
+	++ops;
+      }
+  timer.report(scene.getName(), "click", numManips, ops);
+}
+
+/** Drag: grab the first manipulator and move it back and forth */
+static void
+benchDrag(BenchScene &scene, int numManips, int iters)
+{
+  if (!enabled(scene.getName(), "drag"))
+    return;
+  ManipManager *manager = ManipManager::getManipManager();
+  const int numSteps = 64;
+  GleemV3f origTranslation = scene.getTranslation(0);
+  int x, y;
+  projectToWindow(origTranslation, x, y);
+  unsigned long ops = 0;
+  BenchTimer timer;
+  for (int iter = 0; iter < iters; iter++)
+    {
+      manager->mouseMethod(windowID, GLUT_LEFT_BUTTON, GLUT_DOWN, x, y);
+      for (int i = 0; i < numSteps; i++)
+	{
+	  int offset = (i < numSteps / 2) ? i : (numSteps - i);
+	  manager->motionMethod(windowID, x + offset, y + offset / 2);
+	  ++ops;
+	}
+      manager->mouseMethod(windowID, GLUT_LEFT_BUTTON, GLUT_UP, x, y);
+    }
+  timer.report(scene.getName(), "drag", numManips, ops);
+  scene.setTranslation(0, origTranslation);
+}
+
+/** Recalc storm: reposition every manipulator */
+static void
+benchRecalc(BenchScene &scene, int numManips, int iters)
+{
+  if (!enabled(scene.getName(), "recalc"))
+    return;
+  vector<GleemV3f> origTranslations;
+  int i;
+  for (i = 0; i < scene.getNumManips(); i++)
+    origTranslations.push_back(scene.getTranslation(i));
+  unsigned long ops = 0;
+  BenchTimer timer;
+  for (int iter = 0; iter < iters; iter++)
+    for (i = 0; i < scene.getNumManips(); i++)
+      {
+	GleemV3f t(origTranslations[i]);
+	t[2] = (float) (iter & 1);
+	scene.setTranslation(i, t);
+	++ops;
+      }
+  timer.report(scene.getName(), "recalc", numManips, ops);
+  for (i = 0; i < scene.getNumManips(); i++)
+    scene.setTranslation(i, origTranslations[i]);
+}
+
+/** Batched picking of every pixel in a block at the center of the
+    window */
+static void
+benchPickRays(BenchScene &scene, int numManips, int iters)
+{
+  if (!enabled(scene.getName(), "pickrays"))
+    return;
+  ManipManager *manager = ManipManager::getManipManager();
+  const int blockSize = 64;
+  const int numRays = blockSize * blockSize;
+  GleemV3f *sources = new GleemV3f[numRays];
+  GleemV3f *directions = new GleemV3f[numRays];
+  HitPoint *hits = new HitPoint[numRays];
+  int x0 = (windowSize - blockSize) / 2;
+  int y0 = (windowSize - blockSize) / 2;
+  unsigned long ops = 0;
+  BenchTimer timer;
+  for (int iter = 0; iter < iters; iter++)
+    {
+      manager->mapPixelsToRays(windowID, x0, y0, blockSize, blockSize,
+			       sources, directions);
+      manager->pickRays(windowID, numRays, sources, directions, hits);
+      ops += numRays;
+    }
+  timer.report(scene.getName(), "pickrays", numManips, ops);
+  delete[] hits;
+  delete[] directions;
+  delete[] sources;
+}
+
+//----------------------------------------------------------------------
+// Linear algebra kernels. Build with and without GLEEM_USE_SSE to
+// compare the backends; the group name says which one was used.
+//
+
+#ifdef GLEEM_USE_SSE
+static const char *linalgGroup = "linalg_sse";
+#else
+static const char *linalgGroup = "linalg_scalar";
+#endif
+
+static float
+randomFloat()
+{
+  return 2.0f * ((float) rand() / (float) RAND_MAX) - 1.0f;
+}
+
+// Results are accumulated here so the work can't be optimized away
+static volatile float linalgSink;
+
+static void
+benchLinalg(int iters)
+{
+  const int num = 1024;
+  const int reps = 100 * iters;
+  GleemV3f *vecs = new GleemV3f[num];
+  GleemV3f *results = new GleemV3f[num];
+  GleemMat4f *mats = new GleemMat4f[num];
+  GleemRot *rots = new GleemRot[num];
+  int i, rep;
+  srand(1);
+  for (i = 0; i < num; i++)
+    {
+      vecs[i].setValue(randomFloat(), randomFloat(), randomFloat());
+      rots[i].setValue(vecs[i], randomFloat());
+      mats[i].makeIdent();
+      rots[i].toMatrix(mats[i]);
+      mats[i].setTranslation(vecs[(i + 1) % num]);
+    }
+
+  if (enabled(linalgGroup, "dot"))
+    {
+      float sum = 0;
+      BenchTimer timer;
+      for (rep = 0; rep < reps; rep++)
+	for (i = 0; i < num - 1; i++)
+	  sum += vecs[i].dot(vecs[i + 1]);
+      timer.report(linalgGroup, "dot", num, (unsigned long) reps * (num - 1));
+      linalgSink = sum;
+    }
+
+  if (enabled(linalgGroup, "cross"))
+    {
+      BenchTimer timer;
+      for (rep = 0; rep < reps; rep++)
+	for (i = 0; i < num - 1; i++)
+	  GleemV3f::cross(vecs[i], vecs[i + 1], results[i]);
+      timer.report(linalgGroup, "cross", num,
+		   (unsigned long) reps * (num - 1));
+      linalgSink = results[rep % (num - 1)][0];
+    }
+
+  if (enabled(linalgGroup, "normalize"))
+    {
+      BenchTimer timer;
+      for (rep = 0; rep < reps; rep++)
+	for (i = 0; i < num; i++)
+	  {
+	    results[i] = vecs[i];
+	    results[i].normalize();
+	  }
+      timer.report(linalgGroup, "normalize", num, (unsigned long) reps * num);
+      linalgSink = results[0][0];
+    }
+
+  if (enabled(linalgGroup, "mat4mult"))
+    {
+      GleemMat4f dest;
+      float sum = 0;
+      BenchTimer timer;
+      for (rep = 0; rep < reps; rep++)
+	for (i = 0; i < num - 1; i++)
+	  {
+	    GleemMat4f::mult(mats[i], mats[i + 1], dest);
+	    sum += dest[0][3];
+	  }
+      timer.report(linalgGroup, "mat4mult", num,
+		   (unsigned long) reps * (num - 1));
+      linalgSink = sum;
+    }
+
+  if (enabled(linalgGroup, "rotmult"))
+    {
+      GleemRot dest;
+      float sum = 0;
+      BenchTimer timer;
+      for (rep = 0; rep < reps; rep++)
+	for (i = 0; i < num - 1; i++)
+	  {
+	    GleemRot::mult(rots[i], rots[i + 1], dest);
+	    sum += dest.length();
+	  }
+      timer.report(linalgGroup, "rotmult", num,
+		   (unsigned long) reps * (num - 1));
+      linalgSink = sum;
+    }
+
+  if (enabled(linalgGroup, "rotatevector"))
+    {
+      BenchTimer timer;
+      for (rep = 0; rep < reps; rep++)
+	for (i = 0; i < num; i++)
+	  rots[rep % num].rotateVector(vecs[i], results[i]);
+      timer.report(linalgGroup, "rotatevector", num,
+		   (unsigned long) reps * num);
+      linalgSink = results[0][0];
+    }
+
+  if (enabled(linalgGroup, "rotatevectors"))
+    {
+      BenchTimer timer;
+      for (rep = 0; rep < reps; rep++)
+	rots[rep % num].rotateVectors(num, vecs, results);
+      timer.report(linalgGroup, "rotatevectors", num,
+		   (unsigned long) reps * num);
+      linalgSink = results[0][0];
+    }
+
+  if (enabled(linalgGroup, "xformpt"))
+    {
+      BenchTimer timer;
+      for (rep = 0; rep < reps; rep++)
+	for (i = 0; i < num; i++)
+	  mats[rep % num].xformPt(vecs[i], results[i]);
+      timer.report(linalgGroup, "xformpt", num, (unsigned long) reps * num);
+      linalgSink = results[0][0];
+    }
+
+  delete[] rots;
+  delete[] mats;
+  delete[] results;
+  delete[] vecs;
+}
+
+static void
+runScene(BenchScene &scene, int numManips, int iters)
+{
+  bool any = false;
+  static const char *ops[] = { "create", "hover", "click", "drag",
+			       "recalc", "pickrays", "destroy" };
+  for (int i = 0; i < sizeof(ops) / sizeof(ops[0]); i++)
+    if (enabled(scene.getName(), ops[i]))
+      any = true;
+  if (!any)
+    return;
+
+  setUpCamera(scene, numManips);
+  BenchTimer timer;
+  scene.create(numManips);
+  if (enabled(scene.getName(), "create"))
+    timer.report(scene.getName(), "create", numManips, numManips);
+
+  benchHover(scene, numManips, iters);
+  benchClick(scene, numManips, iters);
+  benchDrag(scene, numManips, iters);
+  benchRecalc(scene, numManips, iters);
+  benchPickRays(scene, numManips, iters);
+
+  timer.start();
+  scene.destroy();
+  if (enabled(scene.getName(), "destroy"))
+    timer.report(scene.getName(), "destroy", numManips, numManips);
+}
+
+//----------------------------------------------------------------------
+// Moving many objects with one manipulator
+//
+
+class TargetCBData
+{
+public:
+  const ManipTargets *targets;
+  GleemMat4f baseInverse;
+  int index;
+};
+
+/** What an application without Manip::setTargets() does for each
+    selected object */
+static void
+targetMotionCB(void *userData, Manip *manip)
+{
+  TargetCBData *data = (TargetCBData *) userData;
+  HandleBoxManip *hb = (HandleBoxManip *) manip;
+  ManipState state;
+  state.translation = hb->getTranslation();
+  state.rotation = hb->getRotation();
+  state.scale = hb->getScale();
+  GleemMat4f cur, delta, src, dst;
+  state.getMatrix(cur);
+  GleemMat4f::mult(cur, data->baseInverse, delta);
+  const ManipTargets *targets = data->targets;
+  int i = data->index;
+  src.makeIdent();
+  for (int e = 0; e < 12; e++)
+    src[e / 4][e % 4] = targets->src[e][i];
+  GleemMat4f::mult(delta, src, dst);
+  for (int e = 0; e < 12; e++)
+    targets->dst[e][i] = dst[e / 4][e % 4];
+}
+
+static void
+benchTargets(int numTargets, int iters)
+{
+  if (!enabled("targets", "callbacks") && !enabled("targets", "bound"))
+    return;
+  HandleBoxManip *manip = new HandleBoxManip();
+  manip->setTranslation(GleemV3f(0, 0, -10));
+  float *src = new float[12 * numTargets];
+  float *dst = new float[12 * numTargets];
+  int i;
+  for (i = 0; i < 12 * numTargets; i++)
+    {
+      src[i] = randomFloat();
+      dst[i] = 0;
+    }
+  ManipTargets targets;
+  targets.count = numTargets;
+  for (i = 0; i < 12; i++)
+    {
+      targets.src[i] = src + i * numTargets;
+      targets.dst[i] = dst + i * numTargets;
+    }
+  const int numSteps = 64;
+  unsigned long ops;
+
+  if (enabled("targets", "callbacks"))
+    {
+      ManipState state;
+      state.translation = manip->getTranslation();
+      TargetCBData *data = new TargetCBData[numTargets];
+      for (i = 0; i < numTargets; i++)
+	{
+	  data[i].targets = &targets;
+	  state.getMatrix(data[i].baseInverse);
+	  data[i].baseInverse.invertAffine();
+	  data[i].index = i;
+	}
+      ops = 0;
+      BenchTimer timer;
+      for (int iter = 0; iter < iters; iter++)
+	for (int step = 0; step < numSteps; step++)
+	  {
+	    manip->setTranslation(GleemV3f(0.01f * step, 0, -10));
+	    for (i = 0; i < numTargets; i++)
+	      targetMotionCB(&data[i], manip);
+	    ++ops;
+	  }
+      timer.report("targets", "callbacks", numTargets, ops);
+      delete[] data;
+    }
+
+  if (enabled("targets", "bound"))
+    {
+      manip->setTranslation(GleemV3f(0, 0, -10));
+      manip->setTargets(&targets);
+      ops = 0;
+      BenchTimer timer;
+      for (int iter = 0; iter < iters; iter++)
+	for (int step = 0; step < numSteps; step++)
+	  {
+	    manip->setTranslation(GleemV3f(0.01f * step, 0, -10));
+	    manip->updateTargets();
+	    ++ops;
+	  }
+      timer.report("targets", "bound", numTargets, ops);
+      manip->setTargets(NULL);
+    }
+
+  delete[] dst;
+  delete[] src;
+  delete manip;
+}
+
+//----------------------------------------------------------------------
+// Replay
+//
+
+static void
+printBits(const char *name, const float *vals, int num)
+{
+  printf(" %s=", name);
+  for (int i = 0; i < num; i++)
+    {
+      union
+      {
+	float f;
+	unsigned int u;
+      } bits;
+      bits.f = vals[i];
+      printf("%s%08x", (i > 0) ? "," : "", bits.u);
+    }
+}
+
+static int
+replay(const char *fileName)
+{
+  // Same scene as TestHandleBox
+  ManipManager *manager = ManipManager::getManipManager();
+  HandleBoxManip *manip = new HandleBoxManip();
+  manip->setTranslation(GleemV3f(0, 0, -10));
+
+  EventLog log;
+  if (log.openForReading(fileName) == false)
+    return 1;
+
+  static const char *typeNames[] = { "unknown", "mouse", "motion",
+				     "passivemotion", "camera" };
+  const int numTypes = sizeof(typeNames) / sizeof(typeNames[0]);
+  GleemInt64 nanos[numTypes];
+  unsigned long allocs[numTypes];
+  unsigned long counts[numTypes];
+  int i;
+  for (i = 0; i < numTypes; i++)
+    {
+      nanos[i] = 0;
+      allocs[i] = 0;
+      counts[i] = 0;
+    }
+
+  EventLog::Event event;
+  while (log.read(event))
+    {
+      int type = (int) event.type;
+      if ((type < 0) || (type >= numTypes))
+	type = 0;
+      unsigned long startAllocs = numAllocs;
+      GleemInt64 startTime = Clock::nanoTime();
+      manager->replayEvent(event);
+      nanos[type] += Clock::nanoTime() - startTime;
+      allocs[type] += numAllocs - startAllocs;
+      ++counts[type];
+    }
+
+  for (i = 1; i < numTypes; i++)
+    {
+      if (counts[i] == 0)
+	continue;
+      printf("bench=replay.%s n=1 ops=%lu ns_per_op=%.1f allocs_per_op=%.3f\n",
+	     typeNames[i], counts[i],
+	     (double) nanos[i] / (double) counts[i],
+	     (double) allocs[i] / (double) counts[i]);
+    }
+
+  GleemMat4f rotMat;
+  rotMat.makeIdent();
+  manip->getRotation().toMatrix(rotMat);
+  float rot[9];
+  for (i = 0; i < 9; i++)
+    rot[i] = rotMat[i / 3][i % 3];
+  float vals[3];
+  printf("state manip=0");
+  for (i = 0; i < 3; i++)
+    vals[i] = manip->getTranslation()[i];
+  printBits("translation", vals, 3);
+  printBits("rotation", rot, 9);
+  for (i = 0; i < 3; i++)
+    vals[i] = manip->getScale()[i];
+  printBits("scale", vals, 3);
+  printf("\n");
+
+  delete manip;
+  return 0;
+}
+
+static void
+usage(const char *progName)
+{
+  fprintf(stderr,
+	  "usage: %s [-n numManips] [-depth treeDepth] [-iters iterations]\n"
+	  "          [-only substring] [-trace traceFile] [-noarenas]\n"
+	  "          [-notables] [-nolod] [-targets numTargets]\n"
+	  "          [-targetthreads n]\n"
+	  "       %s -replay eventLog [-trace traceFile]\n",
+	  progName, progName);
+  exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+  int numManips = 64;
+  int depth = 6;
+  int iters = 10;
+  const char *replayLog = NULL;
+  const char *traceFile = NULL;
+  bool partArenas = true;
+  bool partTables = true;
+  bool lod = true;
+  int numTargets = 5000;
+  int targetThreads = 0;
+
+  for (int i = 1; i < argc; i++)
+    {
+      if ((i + 1 < argc) && !strcmp(argv[i], "-n"))
+	numManips = atoi(argv[++i]);
+      else if ((i + 1 < argc) && !strcmp(argv[i], "-depth"))
+	depth = atoi(argv[++i]);
+      else if ((i + 1 < argc) && !strcmp(argv[i], "-iters"))
+	iters = atoi(argv[++i]);
+      else if ((i + 1 < argc) && !strcmp(argv[i], "-only"))
+	onlyBench = argv[++i];
+      else if ((i + 1 < argc) && !strcmp(argv[i], "-replay"))
+	replayLog = argv[++i];
+      else if ((i + 1 < argc) && !strcmp(argv[i], "-trace"))
+	traceFile = argv[++i];
+      else if (!strcmp(argv[i], "-noarenas"))
+	partArenas = false;
+      else if (!strcmp(argv[i], "-notables"))
+	partTables = false;
+      else if (!strcmp(argv[i], "-nolod"))
+	lod = false;
+      else if ((i + 1 < argc) && !strcmp(argv[i], "-targets"))
+	numTargets = atoi(argv[++i]);
+      else if ((i + 1 < argc) && !strcmp(argv[i], "-targetthreads"))
+	targetThreads = atoi(argv[++i]);
+      else
+	usage(argv[0]);
+    }
+  if ((numManips < 1) || (depth < 0) || (depth > 16) || (iters < 1) ||
+      (numTargets < 1) || (targetThreads < 0))
+    usage(argv[0]);
+
+  // No display: don't touch GLUT. All manipulators go into a single
+  // synthetic window.
+  ManipManager::init(false);
+  ManipManager *manager = ManipManager::getManipManager();
+  manager->windowCreated(windowID);
+  manager->setDefaultWindow(windowID);
+  manager->setPartArenasEnabled(partArenas);
+  manager->setPartTablesEnabled(partTables);
+  manager->setTargetThreads(targetThreads);
+  if (!lod)
+    manager->setDetailThresholds(0, 0);
+
+  int status = 0;
+  if (replayLog != NULL)
+    status = replay(replayLog);
+  else
+    {
+      GridScene<HandleBoxManip> handleBoxScene("handlebox");
+      GridScene<Translate1Manip> translate1Scene("translate1");
+      Translate2Scene translate2Scene;
+      GroupTreeScene groupTreeScene(depth);
+
+      runScene(handleBoxScene, numManips, iters);
+      runScene(translate1Scene, numManips, iters);
+      runScene(translate2Scene, numManips, iters);
+      runScene(groupTreeScene, numManips, iters);
+      benchLinalg(iters);
+      benchTargets(numTargets, iters);
+    }
+
+  if ((traceFile != NULL) && !Trace::writeChromeTrace(traceFile))
+    status = 1;
+  return status;
+}
@@ -15,11 +15,14 @@
 GLEEM_ENTER_NAMESPACE
 
 /** The information gleem needs to construct a 3D ray from the glut
-    mouse callback. Note that gleem currently does not support
-    asymmetrical or orthogonal viewing frusta; your viewing frustum
-    must be a right truncated pyramid. The parameters vertFOV and
-    imagePlaneAspectRatio correspond roughly to the parameters to
-    gluPerspective(). */
+    mouse callback. With the default mapping (RightTruncPyrMapping)
+    your viewing frustum must be a right truncated pyramid, and the
+    parameters vertFOV and imagePlaneAspectRatio correspond roughly to
+    the parameters to gluPerspective(). For orthographic or
+    asymmetrical frusta install an OrthographicMapping or
+    ObliqueTruncPyrMapping for the window (see
+    ManipManager::setScreenToRayMapping()); these carry their own
+    extents and ignore vertFOV and imagePlaneAspectRatio. */
 
 class GLEEMDLL CameraParameters
 {
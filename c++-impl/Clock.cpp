@@ -0,0 +1,44 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifdef WIN32
+# include <windows.h>
+#else
+# include <time.h>
+# include <sys/time.h>
+#endif
+#include <gleem/Clock.h>
+
+GLEEM_USE_NAMESPACE
+
+GleemInt64
+Clock::nanoTime()
+{
+#ifdef WIN32
+  static LARGE_INTEGER frequency;
+  static bool initialized = false;
+  if (!initialized)
+    {
+      QueryPerformanceFrequency(&frequency);
+      initialized = true;
+    }
+  LARGE_INTEGER count;
+  QueryPerformanceCounter(&count);
+  // Split to avoid overflowing the multiplication
+  GleemInt64 secs = count.QuadPart / frequency.QuadPart;
+  GleemInt64 rem = count.QuadPart % frequency.QuadPart;
+  return (secs * 1000000000) + ((rem * 1000000000) / frequency.QuadPart);
+#elif defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (((GleemInt64) ts.tv_sec) * 1000000000) + ts.tv_nsec;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (((GleemInt64) tv.tv_sec) * 1000000000) +
+    (((GleemInt64) tv.tv_usec) * 1000);
+#endif
+}
@@ -0,0 +1,36 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_CLOCK_H
+#define _GLEEM_CLOCK_H
+
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+
+GLEEM_ENTER_NAMESPACE
+
+#ifdef WIN32
+typedef __int64 GleemInt64;
+#else
+typedef long long GleemInt64;
+#endif
+
+/** High-resolution timer used by gleem's instrumentation. */
+
+GLEEM_INTERNAL class GLEEMDLL Clock
+{
+public:
+  /** Returns the current time in nanoseconds relative to an arbitrary
+      fixed origin. Only differences between two values are
+      meaningful. The actual resolution depends on the platform (one
+      microsecond where only gettimeofday() is available). */
+  static GleemInt64 nanoTime();
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_CLOCK_H
@@ -0,0 +1,243 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <string.h>
+#include <iostream.h>
+#include <gleem/EventLog.h>
+
+GLEEM_USE_NAMESPACE
+
+static const char magic[8] = { 'G', 'L', 'E', 'E', 'M', 'L', 'O', 'G' };
+static const int version = 1;
+
+EventLog::EventLog()
+{
+  file = NULL;
+  writing = false;
+}
+
+EventLog::~EventLog()
+{
+  close();
+}
+
+bool
+EventLog::openForWriting(const char *fileName)
+{
+  close();
+  file = fopen(fileName, "wb");
+  if (file == NULL)
+    {
+      cerr << "gleem::EventLog::openForWriting: ERROR: can not open \""
+	   << fileName << "\"" << endl;
+      return false;
+    }
+  writing = true;
+  fwrite(magic, 1, sizeof(magic), file);
+  writeInt(version);
+  return true;
+}
+
+bool
+EventLog::openForReading(const char *fileName)
+{
+  close();
+  file = fopen(fileName, "rb");
+  if (file == NULL)
+    {
+      cerr << "gleem::EventLog::openForReading: ERROR: can not open \""
+	   << fileName << "\"" << endl;
+      return false;
+    }
+  writing = false;
+  char buf[sizeof(magic)];
+  int fileVersion;
+  if ((fread(buf, 1, sizeof(buf), file) != sizeof(buf)) ||
+      (memcmp(buf, magic, sizeof(magic)) != 0) ||
+      (readInt(fileVersion) == false))
+    {
+      cerr << "gleem::EventLog::openForReading: ERROR: \""
+	   << fileName << "\" is not an event log" << endl;
+      close();
+      return false;
+    }
+  if (fileVersion != version)
+    {
+      cerr << "gleem::EventLog::openForReading: ERROR: \""
+	   << fileName << "\" has unsupported version " << fileVersion
+	   << endl;
+      close();
+      return false;
+    }
+  return true;
+}
+
+void
+EventLog::close()
+{
+  if (file != NULL)
+    {
+      fclose(file);
+      file = NULL;
+    }
+  writing = false;
+}
+
+bool
+EventLog::isWriting() const
+{
+  return ((file != NULL) && writing);
+}
+
+bool
+EventLog::isReading() const
+{
+  return ((file != NULL) && !writing);
+}
+
+void
+EventLog::write(const Event &event)
+{
+  if (!isWriting())
+    return;
+  putc((int) event.type, file);
+  writeInt(event.windowID);
+  switch (event.type)
+    {
+    case MOUSE:
+      writeInt(event.button);
+      writeInt(event.state);
+      writeInt(event.modifiers);
+      // FALLTHROUGH
+    case MOTION:
+    case PASSIVE_MOTION:
+      writeInt(event.x);
+      writeInt(event.y);
+      break;
+    case CAMERA:
+      writeV3f(event.params.position);
+      writeV3f(event.params.forwardDirection);
+      writeV3f(event.params.upDirection);
+      writeFloat(event.params.vertFOV);
+      writeFloat(event.params.imagePlaneAspectRatio);
+      writeInt(event.params.xSize);
+      writeInt(event.params.ySize);
+      break;
+    }
+}
+
+bool
+EventLog::read(Event &event)
+{
+  if (!isReading())
+    return false;
+  int type = getc(file);
+  if (type == EOF)
+    return false;
+  bool ok = readInt(event.windowID);
+  event.type = (EventType) type;
+  switch (type)
+    {
+    case MOUSE:
+      ok = ok && readInt(event.button);
+      ok = ok && readInt(event.state);
+      ok = ok && readInt(event.modifiers);
+      // FALLTHROUGH
+    case MOTION:
+    case PASSIVE_MOTION:
+      ok = ok && readInt(event.x);
+      ok = ok && readInt(event.y);
+      break;
+    case CAMERA:
+      ok = ok && readV3f(event.params.position);
+      ok = ok && readV3f(event.params.forwardDirection);
+      ok = ok && readV3f(event.params.upDirection);
+      ok = ok && readFloat(event.params.vertFOV);
+      ok = ok && readFloat(event.params.imagePlaneAspectRatio);
+      ok = ok && readInt(event.params.xSize);
+      ok = ok && readInt(event.params.ySize);
+      break;
+    default:
+      ok = false;
+      break;
+    }
+  if (!ok)
+    {
+      cerr << "gleem::EventLog::read: ERROR: truncated or corrupt event log"
+	   << endl;
+      return false;
+    }
+  return true;
+}
+
+void
+EventLog::writeInt(int val)
+{
+  unsigned int u = (unsigned int) val;
+  unsigned char buf[4];
+  buf[0] = (unsigned char) (u & 0xFF);
+  buf[1] = (unsigned char) ((u >> 8) & 0xFF);
+  buf[2] = (unsigned char) ((u >> 16) & 0xFF);
+  buf[3] = (unsigned char) ((u >> 24) & 0xFF);
+  fwrite(buf, 1, 4, file);
+}
+
+void
+EventLog::writeFloat(float val)
+{
+  union
+  {
+    float f;
+    int i;
+  } bits;
+  bits.f = val;
+  writeInt(bits.i);
+}
+
+void
+EventLog::writeV3f(const GleemV3f &val)
+{
+  writeFloat(val[0]);
+  writeFloat(val[1]);
+  writeFloat(val[2]);
+}
+
+bool
+EventLog::readInt(int &val)
+{
+  unsigned char buf[4];
+  if (fread(buf, 1, 4, file) != 4)
+    return false;
+  val = (int) (((unsigned int) buf[0]) |
+	       (((unsigned int) buf[1]) << 8) |
+	       (((unsigned int) buf[2]) << 16) |
+	       (((unsigned int) buf[3]) << 24));
+  return true;
+}
+
+bool
+EventLog::readFloat(float &val)
+{
+  union
+  {
+    float f;
+    int i;
+  } bits;
+  if (readInt(bits.i) == false)
+    return false;
+  val = bits.f;
+  return true;
+}
+
+bool
+EventLog::readV3f(GleemV3f &val)
+{
+  float x, y, z;
+  if (!readFloat(x) || !readFloat(y) || !readFloat(z))
+    return false;
+  val.setValue(x, y, z);
+  return true;
+}
@@ -0,0 +1,100 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_EVENT_LOG_H
+#define _GLEEM_EVENT_LOG_H
+
+#include <stdio.h>
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+#include <gleem/CameraParameters.h>
+
+GLEEM_ENTER_NAMESPACE
+
+/** A compact binary log of the input events and camera updates seen
+    by the ManipManager. See ManipManager::startRecording() and
+    ManipManager::replayEvents().
+
+    The file starts with the eight bytes "GLEEMLOG" followed by a
+    32-bit version number. Each event is then one type byte followed
+    by its fields, every field stored as 32 bits in little-endian
+    order (floats by their IEEE bit pattern), so logs can be moved
+    between machines and replay bit-exactly. */
+
+class GLEEMDLL EventLog
+{
+public:
+  enum EventType
+  {
+    MOUSE = 1,
+    MOTION = 2,
+    PASSIVE_MOTION = 3,
+    CAMERA = 4
+  };
+
+  /** One logged event. Only the fields relevant to the type are
+      meaningful. */
+  class GLEEMDLL Event
+  {
+  public:
+    EventType type;
+    int windowID;
+    /** MOUSE only */
+    int button;
+    /** MOUSE only */
+    int state;
+    /** MOUSE only */
+    int modifiers;
+    /** MOUSE, MOTION and PASSIVE_MOTION */
+    int x;
+    /** MOUSE, MOTION and PASSIVE_MOTION */
+    int y;
+    /** CAMERA only */
+    CameraParameters params;
+  };
+
+  EventLog();
+  /** Closes the file if it is still open */
+  ~EventLog();
+
+  /** Creates (or truncates) the named file and writes the header.
+      Returns false and prints an error if the file could not be
+      opened. */
+  bool openForWriting(const char *fileName);
+
+  /** Opens the named file and checks the header. Returns false and
+      prints an error if the file could not be opened or is not an
+      event log. */
+  bool openForReading(const char *fileName);
+
+  void close();
+  bool isWriting() const;
+  bool isReading() const;
+
+  /** Appends an event. Has no effect unless the log is open for
+      writing. */
+  void write(const Event &event);
+
+  /** Reads the next event. Returns false at the end of the log or if
+      the log is corrupt (in which case an error is printed). */
+  bool read(Event &event);
+
+private:
+  void writeInt(int val);
+  void writeFloat(float val);
+  void writeV3f(const GleemV3f &val);
+  bool readInt(int &val);
+  bool readFloat(float &val);
+  bool readV3f(GleemV3f &val);
+
+  FILE *file;
+  bool writing;
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_EVENT_LOG_H
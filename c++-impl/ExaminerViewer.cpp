@@ -19,8 +19,6 @@
 
 GLEEM_USE_NAMESPACE
 
-#define EPSILON 0.0001f
-
 // How many examiner viewers do we expect to instantiate?
 static const int NUM_EXAMINER_VIEWERS = 16;
 ExaminerViewer::WindowToExaminerViewerTable
@@ -62,6 +60,7 @@ ExaminerViewer::operator=(const ExaminerViewer &viewer)
   dollySpeed = viewer.dollySpeed;
   minDollySpeed = viewer.minDollySpeed;
   params = viewer.params;
+  dirty = true;
   interactionUnderway = false;
   iOwnInteraction = false;
   provider = viewer.provider;
@@ -71,7 +70,20 @@ ExaminerViewer::operator=(const ExaminerViewer &viewer)
 void
 ExaminerViewer::update()
 {
-  recalc();
+  if (dirty)
+    recalc();
+}
+
+bool
+ExaminerViewer::needsUpdate() const
+{
+  return dirty;
+}
+
+void
+ExaminerViewer::markDirty()
+{
+  dirty = true;
 }
 
 const CameraParameters &
@@ -80,6 +92,18 @@ ExaminerViewer::getCameraParameters() const
   return params;
 }
 
+const GleemMat4f &
+ExaminerViewer::getModelviewMatrix() const
+{
+  return modelview;
+}
+
+const GleemMat4f &
+ExaminerViewer::getInverseModelviewMatrix() const
+{
+  return inverseModelview;
+}
+
 const GleemRot &
 ExaminerViewer::getOrientation() const
 {
@@ -218,8 +242,11 @@ ExaminerViewer::init(int windowID)
   button1Down = false;
   button2Down = false;
   provider = NULL;
+  dirty = true;
 
   position.setValue(0, 0, 0);
+  modelview.makeIdent();
+  inverseModelview.makeIdent();
 
   params.position.setValue(0, 0, 0);
   params.forwardDirection.setValue(0, 0, -1);
@@ -350,6 +377,7 @@ ExaminerViewer::motionMethod(int x, int y)
 	  backOut.normalize();
 	  GleemV3f::scale(backOut, -1.0f * focalDist, backOut);
 	  position = position + backOut + diff;
+	  dirty = true;
 	}
       else if (button2Down && (!button1Down))
 	{
@@ -362,6 +390,7 @@ ExaminerViewer::motionMethod(int x, int y)
 	  GleemV3f worldDiff = orientation.rotateVector(localDiff);
 	  // Add on to position
 	  GleemV3f::add(worldDiff, position, position);
+	  dirty = true;
 	}
       else if (button1Down && button2Down)
 	{
@@ -378,6 +407,7 @@ ExaminerViewer::motionMethod(int x, int y)
 	  focalDist += focalDiff;
 	  if (focalDist < minFocalDist)
 	    focalDist = minFocalDist;
+	  dirty = true;
 	}
     }
 }
@@ -396,11 +426,13 @@ ExaminerViewer::reshapeMethod(int w, int h)
   params.imagePlaneAspectRatio = aspect;
   params.xSize = w;
   params.ySize = h;
+  dirty = true;
 }
 
 void
 ExaminerViewer::recalc()
 {
+  dirty = false;
   makeCurrent();
   // Recompute position, forward and up vectors
   params.position = position;
@@ -413,16 +445,21 @@ ExaminerViewer::recalc()
   //  cerr << "focalDist: " << focalDist << endl;
 
   // Compute modelview matrix based on camera parameters, position and
-  // orientation
+  // orientation. The camera-to-world transform is the orientation
+  // followed by the translation to the camera's position; the
+  // modelview matrix is its (rigid) inverse.
+  inverseModelview.makeIdent();
+  inverseModelview.setRotation(orientation);
+  inverseModelview.setTranslation(position);
+  modelview = inverseModelview;
+  modelview.invertRigid();
+  // OpenGL wants column major
+  GLfloat glMat[16];
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 4; j++)
+      glMat[j * 4 + i] = modelview[i][j];
   glMatrixMode(GL_MODELVIEW);
-  glLoadIdentity();
-  GleemV3f axis;
-  float ang = orientation.getValue(axis);
-  if (axis.lengthSquared() > EPSILON)
-    glRotatef(GLEEM_RAD_TO_DEG(ang), -axis[0], -axis[1], -axis[2]);
-  glTranslatef(-position[0], -position[1], -position[2]);
-  //  glTranslatef(0, 0, 10);
-  //  glRotatef(15, 0, 1, 0);
+  glLoadMatrixf(glMat);
   glMatrixMode(GL_PROJECTION);
   glLoadIdentity();
   gluPerspective(GLEEM_RAD_TO_DEG(params.vertFOV * 2.0f),
@@ -50,13 +50,33 @@ public:
   ExaminerViewer &operator=(const ExaminerViewer &);
 
   /** Call this at the end of your idle function to cause the
-      Modelview matrix to be recomputed. */
+      Modelview and Projection matrices to be recomputed and loaded
+      into this viewer's context. Does nothing unless the view has
+      changed since the last call (through mouse motion, a reshape of
+      the window or viewAll()), so it is cheap to call every tick. */
   void update();
 
+  /** Returns true if the view has changed since the last update() */
+  bool needsUpdate() const;
+
+  /** Makes the next update() recompute and reload the matrices even
+      if the view has not changed; for example, after the application
+      has loaded matrices of its own into this viewer's context. */
+  void markDirty();
+
   /** Get the camera parameters out of this Examiner Viewer (for
-      example, to pass to ManipManager::updateCameraParameters()) */
+      example, to pass to ManipManager::updateCameraParameters(),
+      which does no work if they have not changed). These are as of
+      the last update(). */
   const CameraParameters &getCameraParameters() const;
 
+  /** The Modelview matrix loaded by the last update(), and its
+      inverse, which maps from camera space to world space. Like all
+      GleemMat4fs these are row major and multiply column vectors;
+      transpose them to pass to glLoadMatrixf(). */
+  const GleemMat4f &getModelviewMatrix() const;
+  const GleemMat4f &getInverseModelviewMatrix() const;
+
   /** FIXME: A hack to get the orientation directly (not contained in
       CameraParameters structure) */
   const GleemRot &getOrientation() const;
@@ -127,6 +147,12 @@ protected:
   float minDollySpeed;
   CameraParameters params;
 
+  /** Set when the view changes; cleared by update() */
+  bool dirty;
+  /** Computed by recalc() */
+  GleemMat4f modelview;
+  GleemMat4f inverseModelview;
+
   /** Simple state machine for figuring out whether we are grabbing
       events */
   bool interactionUnderway;
@@ -140,6 +166,9 @@ protected:
   /** Our bounding sphere provider */
   BSphereProvider *provider;
 
+  /** Recomputes params and the matrices from the camera's position
+      and orientation and loads the matrices into this viewer's
+      context */
   void recalc();
 
   /** Hash table mapping window IDs to ExaminerViewer objects */
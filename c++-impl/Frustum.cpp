@@ -0,0 +1,112 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <gleem/Frustum.h>
+
+GLEEM_USE_NAMESPACE
+
+Frustum::Frustum()
+{
+  makeEmpty();
+}
+
+void
+Frustum::makeEmpty()
+{
+  numPlanes = 0;
+}
+
+bool
+Frustum::addPlane(const GleemV3f &normal, const GleemV3f &point)
+{
+  if (numPlanes == MAX_PLANES)
+    return false;
+  GleemV3f n = normal;
+  // Degenerate planes (for example, from a zero-area rectangle) are
+  // simply dropped
+  if (n.lengthSquared() == 0.0f)
+    return true;
+  n.normalize();
+  normals[numPlanes] = n;
+  offsets[numPlanes] = n.dot(point);
+  numPlanes++;
+  return true;
+}
+
+int
+Frustum::getNumPlanes() const
+{
+  return numPlanes;
+}
+
+void
+Frustum::setFromCornerRays(const GleemV3f rayStarts[4],
+			   const GleemV3f rayDirections[4])
+{
+  makeEmpty();
+  // A point known to be inside the volume, used to orient the side
+  // planes regardless of the winding of the corners
+  GleemV3f inside(0, 0, 0);
+  GleemV3f meanStart(0, 0, 0);
+  GleemV3f meanDir(0, 0, 0);
+  int i;
+  for (i = 0; i < 4; i++)
+    {
+      GleemV3f dir = rayDirections[i];
+      dir.normalize();
+      meanStart += rayStarts[i];
+      meanDir += dir;
+      inside += rayStarts[i] + dir;
+    }
+  GleemV3f::scale(meanStart, 0.25f, meanStart);
+  GleemV3f::scale(inside, 0.25f, inside);
+  for (i = 0; i < 4; i++)
+    {
+      int next = (i + 1) % 4;
+      // The side plane contains ray i and passes through a point on
+      // ray i + 1
+      GleemV3f toNext = (rayStarts[next] + rayDirections[next]) - rayStarts[i];
+      GleemV3f normal;
+      GleemV3f::cross(rayDirections[i], toNext, normal);
+      if (normal.dot(inside - rayStarts[i]) < 0.0f)
+	normal *= -1.0f;
+      addPlane(normal, rayStarts[i]);
+    }
+  addPlane(meanDir, meanStart);
+}
+
+bool
+Frustum::containsPoint(const GleemV3f &pt) const
+{
+  for (int i = 0; i < numPlanes; i++)
+    if (normals[i].dot(pt) < offsets[i])
+      return false;
+  return true;
+}
+
+bool
+Frustum::intersectsSphere(const BSphere &bsph) const
+{
+  const GleemV3f &center = bsph.getCenter();
+  float negRadius = -bsph.getRadius();
+  for (int i = 0; i < numPlanes; i++)
+    if (normals[i].dot(center) - offsets[i] < negRadius)
+      return false;
+  return true;
+}
+
+void
+Frustum::getScaledAbout(const GleemV3f &center, float scale,
+			Frustum &dest) const
+{
+  dest.numPlanes = numPlanes;
+  for (int i = 0; i < numPlanes; i++)
+    {
+      float nc = normals[i].dot(center);
+      dest.normals[i] = normals[i];
+      dest.offsets[i] = nc + (offsets[i] - nc) / scale;
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_FRUSTUM_H
+#define _GLEEM_FRUSTUM_H
+
+#include <bool.h>
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+#include <gleem/BSphere.h>
+#include <gleem/Linalg.h>
+
+GLEEM_ENTER_NAMESPACE
+
+/** A convex volume bounded by a small number of planes, used for
+    marquee selection and culling queries. Plane normals point into
+    the volume. A frustum with no planes contains everything. */
+
+class GLEEMDLL Frustum
+{
+public:
+  /** Default constructor creates a frustum with no planes */
+  Frustum();
+
+  /** Remove all planes */
+  void makeEmpty();
+
+  /** Add a bounding plane through the given point. The normal must
+      point into the volume and need not be normalized. Returns false
+      if the frustum already has the maximum number of planes. */
+  bool addPlane(const GleemV3f &normal, const GleemV3f &point);
+
+  int getNumPlanes() const;
+
+  /** Set this frustum to the volume bounded by four rays given in
+      order (either winding) around a screen rectangle, plus a near
+      plane through the ray origins perpendicular to the mean ray
+      direction. The rays need not share an origin, so this works for
+      parallel as well as perspective projections. The volume is
+      unbounded in the viewing direction. */
+  void setFromCornerRays(const GleemV3f rayStarts[4],
+			 const GleemV3f rayDirections[4]);
+
+  /** Returns true if the point lies inside or on the frustum */
+  bool containsPoint(const GleemV3f &pt) const;
+
+  /** Returns true if the sphere lies at least partly inside the
+      frustum. This is conservative: spheres near the frustum's edges
+      may be reported as intersecting even though they lie just
+      outside. */
+  bool intersectsSphere(const BSphere &bsph) const;
+
+  /** Sets dest to this frustum as it appears to geometry which is
+      scaled by the given positive factor about the given center: a
+      point p lies in dest exactly when center + scale * (p - center)
+      lies in this frustum */
+  void getScaledAbout(const GleemV3f &center, float scale,
+		      Frustum &dest) const;
+
+private:
+  enum { MAX_PLANES = 6 };
+  /** Unit normals pointing into the volume */
+  GleemV3f normals[MAX_PLANES];
+  /** A point p is inside plane i if normals[i].dot(p) >= offsets[i] */
+  float offsets[MAX_PLANES];
+  int numPlanes;
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_FRUSTUM_H
@@ -10,11 +10,14 @@
 #endif
 #include <GL/glut.h>
 #include <gleem/HandleBoxManip.h>
+#include <gleem/ManipManager.h>
 #include <gleem/ManipPartTransform.h>
 #include <gleem/ManipPartCube.h>
 #include <gleem/ManipPartLineSeg.h>
 #include <gleem/ManipPartSquare.h>
+#include <gleem/ManipPartTable.h>
 #include <gleem/MathUtil.h>
+#include <gleem/Trace.h>
 
 GLEEM_USE_NAMESPACE
 
@@ -25,6 +28,7 @@ HandleBoxManip::HandleBoxManip()
   geometryScale.setValue(1, 1, 1);
   // FIXME
   dragState = INACTIVE;
+  boundsValid = false;
   for (int i = 0; i < 12; i++)
     lineSegs[i] = NULL;
   createGeometry();
@@ -91,10 +95,32 @@ HandleBoxManip::getGeometryScale() const
 void
 HandleBoxManip::render()
 {
-  // FIXME: Add scale handles
   int i;
+  DetailLevel level = getDetailLevel();
+  if (level == POINT_DETAIL)
+    {
+      bool reenable = glIsEnabled(GL_LIGHTING);
+      glDisable(GL_LIGHTING);
+      glBegin(GL_POINTS);
+      // The default color of the box's edges
+      glColor3f(0.8f, 0.8f, 0.8f);
+      glVertex3f(translation[0], translation[1], translation[2]);
+      glEnd();
+      if (reenable)
+	glEnable(GL_LIGHTING);
+      return;
+    }
+  ManipPartTable *table = getActivePartTable();
+  if ((table != NULL) && (level == FULL_DETAIL))
+    {
+      table->render();
+      return;
+    }
+  // FIXME: Add scale handles
   for (i = 0; i < 12; i++)
     lineSegs[i]->render();
+  if (level != FULL_DETAIL)
+    return;
 
   for (i = 0; i < rotateHandles.size(); i++)
     rotateHandles[i].geometry->render();
@@ -108,8 +134,13 @@ HandleBoxManip::intersectRay(const GleemV3f &rayStart,
 			     vector<HitPoint> &results)
 {
   int i;
+  DetailLevel level = getDetailLevel();
+  if (level == POINT_DETAIL)
+    return;
   for (i = 0; i < faces.size(); i++)
     faces[i].centerSquare->intersectRay(rayStart, rayDirection, results);
+  if (level != FULL_DETAIL)
+    return;
   for (i = 0; i < rotateHandles.size(); i++)
     rotateHandles[i].geometry->intersectRay(rayStart, rayDirection, results);
   for (i = 0; i < scaleHandles.size(); i++)
@@ -213,7 +244,7 @@ HandleBoxManip::makeActive(const HitPoint &hit)
       ScaleHandleInfo &info = scaleHandles[i];
       if (info.geometry == hit.manipPart)
 	{
-	  int mods = glutGetModifiers();
+	  int mods = ManipManager::getManipManager()->getModifiers();
 	  if (mods & GLUT_ACTIVE_SHIFT)
 	    {
 	      dragState = SCALE_SINGLE_AXIS;
@@ -441,6 +472,47 @@ HandleBoxManip::drag(const GleemV3f &rayStart,
   Manip::drag(rayStart, rayDirection);
 }
 
+bool
+HandleBoxManip::getBoundingSphere(BSphere &bsph)
+{
+  bsph = bounds;
+  return boundsValid;
+}
+
+bool
+HandleBoxManip::intersectFrustum(const Frustum &frustum)
+{
+  // Test the pickable parts individually, since the overall bounds
+  // are much larger than the box and its handles
+  if (boundsValid && !frustum.intersectsSphere(bounds))
+    return false;
+  int i;
+  for (i = 0; i < faces.size(); i++)
+    if (faces[i].centerSquare->intersectFrustum(frustum))
+      return true;
+  for (i = 0; i < rotateHandles.size(); i++)
+    if (rotateHandles[i].geometry->intersectFrustum(frustum))
+      return true;
+  for (i = 0; i < scaleHandles.size(); i++)
+    if (scaleHandles[i].geometry->intersectFrustum(frustum))
+      return true;
+  return false;
+}
+
+void
+HandleBoxManip::getState(ManipState &state) const
+{
+  state.translation = translation;
+  state.rotation = rotation;
+  state.scale = scale;
+}
+
+Manip::DetailLevel
+HandleBoxManip::getCoarsestDetailLevel() const
+{
+  return POINT_DETAIL;
+}
+
 void
 HandleBoxManip::makeInactive()
 {
@@ -481,6 +553,7 @@ HandleBoxManip::deleteGeometry()
       delete foo.geometry;
     }
   scaleHandles.erase(scaleHandles.begin(), scaleHandles.end());
+  resetPartArena();
 }
 
 void
@@ -702,11 +775,27 @@ HandleBoxManip::createGeometry()
   scaleInfo.faceIndices[1] = 3;
   scaleInfo.faceIndices[2] = 5;
   scaleHandles.push_back(scaleInfo);
+
+  // Publish the same parts intersectRay() tests, after the line
+  // segments so the table renders in the same order as render()
+  ManipPartTable *table = getPartTable();
+  table->clear();
+  int i;
+  for (i = 0; i < 12; i++)
+    table->addRenderRoot(lineSegs[i]);
+  for (i = 0; i < faces.size(); i++)
+    table->addPickRoot(faces[i].centerSquare);
+  for (i = 0; i < rotateHandles.size(); i++)
+    table->addPickRoot(rotateHandles[i].geometry);
+  for (i = 0; i < scaleHandles.size(); i++)
+    table->addPickRoot(scaleHandles[i].geometry);
 }
 
 void
 HandleBoxManip::recalc()
 {
+  GLEEM_TRACE_SCOPE("HandleBoxManip::recalc", this);
+  placementChanged();
   // Construct local to world transform for geometry.
   // Scale, Rotation, Translation. Since we're right multiplying
   // column vectors, the actual matrix composed is TRS.
@@ -727,22 +816,50 @@ HandleBoxManip::recalc()
   GleemMat4f::mult(xlateMat, rotMat, tmpMat);
   GleemMat4f::mult(tmpMat, scaleMat, xform);
   int i;
-  for (i = 0; i < 12; i++)
-    lineSegs[i]->setTransform(xform);
   for (i = 0; i < faces.size(); i++)
     {
       FaceInfo &face = faces[i];
-      face.centerSquare->setTransform(xform);
       xform.xformDir(face.origNormal, face.normal);
       face.normal.normalize();
-      
-      RotateHandleInfo &rotInfo = rotateHandles[i];
-      rotInfo.geometry->setTransform(xform);
+    }
+  ManipPartTable *table = getActivePartTable();
+  if (table != NULL)
+    {
+      table->setTransform(xform);
+      boundsValid = table->getBoundingSphere(bounds);
+      return;
+    }
+  for (i = 0; i < 12; i++)
+    lineSegs[i]->setTransform(xform);
+  for (i = 0; i < faces.size(); i++)
+    {
+      faces[i].centerSquare->setTransform(xform);
+      rotateHandles[i].geometry->setTransform(xform);
     }
   for (i = 0; i < scaleHandles.size(); i++)
     {
       scaleHandles[i].geometry->setTransform(xform);
     }
+  // The rotate and scale handles stick out furthest; the faces are
+  // included so the bounds cover all pickable geometry
+  bounds.makeEmpty();
+  boundsValid = true;
+  BSphere partBounds;
+  for (i = 0; i < faces.size(); i++)
+    {
+      boundsValid &= faces[i].centerSquare->getBoundingSphere(partBounds);
+      bounds.extendBy(partBounds);
+    }
+  for (i = 0; i < rotateHandles.size(); i++)
+    {
+      boundsValid &= rotateHandles[i].geometry->getBoundingSphere(partBounds);
+      bounds.extendBy(partBounds);
+    }
+  for (i = 0; i < scaleHandles.size(); i++)
+    {
+      boundsValid &= scaleHandles[i].geometry->getBoundingSphere(partBounds);
+      bounds.extendBy(partBounds);
+    }
 }
 
 ManipPart *
@@ -750,8 +867,9 @@ HandleBoxManip::createLineSeg(const GleemV3f &translation,
 			      const GleemV3f &xAxis,
 			      const GleemV3f &yAxis)
 {
-  ManipPartTransform *xform = new ManipPartTransform(this);
-  ManipPartLineSeg *lineSeg = new ManipPartLineSeg(this);
+  ManipPartArena *arena = getPartArena();
+  ManipPartTransform *xform = new (arena) ManipPartTransform(this);
+  ManipPartLineSeg *lineSeg = new (arena) ManipPartLineSeg(this);
   xform->addPart(lineSeg);
   GleemMat4f offset;
   offset.makeIdent();
@@ -778,8 +896,9 @@ HandleBoxManip::createFace(const GleemV3f &translation,
 			   const GleemV3f &normal,
 			   const GleemV3f &up)
 {
-  ManipPartTransform *xform = new ManipPartTransform(this);
-  ManipPartSquare *square = new ManipPartSquare(this);
+  ManipPartArena *arena = getPartArena();
+  ManipPartTransform *xform = new (arena) ManipPartTransform(this);
+  ManipPartSquare *square = new (arena) ManipPartSquare(this);
   square->setVisible(false);
   xform->addPart(square);
   GleemMat4f offset;
@@ -805,12 +924,13 @@ HandleBoxManip::createFace(const GleemV3f &translation,
 ManipPart *
 HandleBoxManip::createRotateHandle(const GleemV3f &direction)
 {
-  ManipPartCube *handle = new ManipPartCube(this);
+  ManipPartArena *arena = getPartArena();
+  ManipPartCube *handle = new (arena) ManipPartCube(this);
   GleemMat4f offset;
   offset.makeIdent();
   offset[0][0] = offset[1][1] = offset[2][2] = 0.1f;
   offset.setTranslation(2.0f * direction);
-  ManipPartTransform *xform = new ManipPartTransform(this);
+  ManipPartTransform *xform = new (arena) ManipPartTransform(this);
   xform->addPart(handle);
   xform->setOffsetTransform(offset);
   return xform;
@@ -819,12 +939,13 @@ HandleBoxManip::createRotateHandle(const GleemV3f &direction)
 ManipPart *
 HandleBoxManip::createScaleHandle(const GleemV3f &position)
 {
-  ManipPartCube *handle = new ManipPartCube(this);
+  ManipPartArena *arena = getPartArena();
+  ManipPartCube *handle = new (arena) ManipPartCube(this);
   GleemMat4f offset;
   offset.makeIdent();
   offset[0][0] = offset[1][1] = offset[2][2] = 0.1f;
   offset.setTranslation(position);
-  ManipPartTransform *xform = new ManipPartTransform(this);
+  ManipPartTransform *xform = new (arena) ManipPartTransform(this);
   xform->addPart(handle);
   xform->setOffsetTransform(offset);
   return xform;
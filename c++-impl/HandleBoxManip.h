@@ -81,6 +81,12 @@ GLEEM_INTERNAL public:
   virtual void drag(const GleemV3f &rayStart,
 		    const GleemV3f &rayDirection);
   virtual void makeInactive();
+  virtual bool getBoundingSphere(BSphere &bsph);
+  virtual bool intersectFrustum(const Frustum &frustum);
+  virtual void getState(ManipState &state) const;
+  /** Draws only the box at BOX_DETAIL, where only its faces can be
+      picked, and only its center at POINT_DETAIL */
+  virtual DetailLevel getCoarsestDetailLevel() const;
 
 private:
   void deleteGeometry();
@@ -94,6 +100,9 @@ private:
   GleemRot rotation;
   // Cumulative transform of this object
   GleemMat4f xform;
+  // Bounds of all geometry, recomputed in recalc()
+  BSphere bounds;
+  bool boundsValid;
 
   typedef enum
   {
@@ -0,0 +1,126 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <math.h>
+#include <gleem/LatencyHistogram.h>
+
+GLEEM_USE_NAMESPACE
+
+LatencyHistogram::LatencyHistogram()
+{
+  reset();
+}
+
+void
+LatencyHistogram::reset()
+{
+  for (int i = 0; i < NUM_BUCKETS; i++)
+    counts[i] = 0;
+  totalCount = 0;
+  maxValue = 0;
+}
+
+void
+LatencyHistogram::record(GleemInt64 nanos)
+{
+  if (nanos < 0)
+    nanos = 0;
+  ++counts[bucketIndex(nanos)];
+  ++totalCount;
+  if (nanos > maxValue)
+    maxValue = nanos;
+}
+
+void
+LatencyHistogram::add(const LatencyHistogram &arg)
+{
+  for (int i = 0; i < NUM_BUCKETS; i++)
+    counts[i] += arg.counts[i];
+  totalCount += arg.totalCount;
+  if (arg.maxValue > maxValue)
+    maxValue = arg.maxValue;
+}
+
+unsigned long
+LatencyHistogram::getCount() const
+{
+  return totalCount;
+}
+
+GleemInt64
+LatencyHistogram::getMax() const
+{
+  return maxValue;
+}
+
+GleemInt64
+LatencyHistogram::getPercentile(double percentile) const
+{
+  if (totalCount == 0)
+    return 0;
+  if (percentile < 0)
+    percentile = 0;
+  if (percentile > 100)
+    percentile = 100;
+  double target = ceil((percentile / 100.0) * (double) totalCount);
+  if (target < 1)
+    target = 1;
+  unsigned long seen = 0;
+  for (int i = 0; i < NUM_BUCKETS; i++)
+    {
+      seen += counts[i];
+      if ((double) seen >= target)
+	{
+	  GleemInt64 val = bucketUpperBound(i);
+	  return (val < maxValue) ? val : maxValue;
+	}
+    }
+  return maxValue;
+}
+
+int
+LatencyHistogram::bucketIndex(GleemInt64 val)
+{
+  if (val < SUB_BUCKET_COUNT)
+    return (int) val;
+  // Find the position of the top bit
+  int topBit = SUB_BUCKET_BITS;
+  while ((val >> (topBit + 1)) != 0)
+    ++topBit;
+  // Keep the top SUB_BUCKET_BITS bits, the first of which is always set
+  int shift = topBit - (SUB_BUCKET_BITS - 1);
+  int subBucket = (int) (val >> shift) - SUB_BUCKET_HALF;
+  return (SUB_BUCKET_COUNT + (topBit - SUB_BUCKET_BITS) * SUB_BUCKET_HALF +
+	  subBucket);
+}
+
+GleemInt64
+LatencyHistogram::bucketUpperBound(int index)
+{
+  if (index < SUB_BUCKET_COUNT)
+    return index;
+  index -= SUB_BUCKET_COUNT;
+  int topBit = SUB_BUCKET_BITS + (index / SUB_BUCKET_HALF);
+  int shift = topBit - (SUB_BUCKET_BITS - 1);
+  GleemInt64 subBucket = SUB_BUCKET_HALF + (index % SUB_BUCKET_HALF);
+  GleemInt64 one = 1;
+  return (subBucket << shift) + ((one << shift) - 1);
+}
+
+GLEEM_ENTER_NAMESPACE
+ostream &
+operator<<(ostream &os, const LatencyHistogram &hist)
+{
+  // Print the 64-bit values as doubles; not all iostreams support
+  // long long
+  os << "count=" << hist.getCount()
+     << " p50=" << (double) hist.getPercentile(50)
+     << " p99=" << (double) hist.getPercentile(99)
+     << " p999=" << (double) hist.getPercentile(99.9)
+     << " max=" << (double) hist.getMax();
+  return os;
+}
+GLEEM_EXIT_NAMESPACE
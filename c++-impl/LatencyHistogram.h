@@ -0,0 +1,79 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_LATENCY_HISTOGRAM_H
+#define _GLEEM_LATENCY_HISTOGRAM_H
+
+#include <iostream.h>
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+#include <gleem/Clock.h>
+
+GLEEM_ENTER_NAMESPACE
+
+/** A histogram of latencies in nanoseconds with a fixed relative
+    precision, in the style of HdrHistogram. Values below 32 ns get a
+    bucket each; above that every power of two is split into 16
+    linear buckets, so any recorded value is reported to within 1/16
+    (about 6%) of its true value, from nanoseconds up to the full
+    range of GleemInt64, in a fixed amount of memory and with no
+    allocation when recording. */
+
+class GLEEMDLL LatencyHistogram
+{
+public:
+  /** Default constructor produces an empty histogram */
+  LatencyHistogram();
+
+  /** Remove all recorded values */
+  void reset();
+
+  /** Record one latency. Negative values are recorded as zero. */
+  void record(GleemInt64 nanos);
+
+  /** Add all of the argument's recorded values to this one */
+  void add(const LatencyHistogram &arg);
+
+  /** Number of values recorded */
+  unsigned long getCount() const;
+
+  /** Largest value recorded, exactly; 0 if the histogram is empty */
+  GleemInt64 getMax() const;
+
+  /** Returns the smallest value such that the given percentage
+      (0..100) of the recorded values are at or below it, rounded up
+      to the top of its bucket. Returns 0 if the histogram is
+      empty. */
+  GleemInt64 getPercentile(double percentile) const;
+
+  /** Convenience operator. Prints the count, p50, p99, p999 and max,
+      in nanoseconds, on one line as name=value pairs */
+  friend ostream &operator<<(ostream &os, const LatencyHistogram &hist);
+
+private:
+  enum
+  {
+    SUB_BUCKET_BITS = 5,
+    SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS,
+    SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2,
+    // Values with their top bit at position SUB_BUCKET_BITS through 62
+    // take SUB_BUCKET_HALF buckets per power of two
+    NUM_BUCKETS = SUB_BUCKET_COUNT + (63 - SUB_BUCKET_BITS) * SUB_BUCKET_HALF
+  };
+
+  static int bucketIndex(GleemInt64 val);
+  /** Largest value which maps to the given bucket */
+  static GleemInt64 bucketUpperBound(int index);
+
+  unsigned long counts[NUM_BUCKETS];
+  unsigned long totalCount;
+  GleemInt64 maxValue;
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_LATENCY_HISTOGRAM_H
@@ -12,50 +12,325 @@
 #include <GL/glut.h>
 #include <gleem/Manip.h>
 #include <gleem/ManipManager.h>
+#include <gleem/ManipCallbackWorker.h>
+#include <gleem/ManipPartArena.h>
+#include <gleem/ManipPartTable.h>
+#include <gleem/TaskPool.h>
+#include <gleem/Trace.h>
 
 GLEEM_USE_NAMESPACE
 
-void
-Manip::addMotionCallback(ManipCB *f, void *userData)
+ManipCallbackHandle
+Manip::addMotionCallback(ManipCB *f, void *userData, CallbackPolicy policy)
 {
   if (f == NULL)
     {
       cerr << "Manip::addMotionCallback: ERROR: detected NULL callback function."
 	   << endl;
-      return;
+      return 0;
     }
-  motionCallbacks.push_back(pair<ManipCB *, void *>(f, userData));
+  return motionCallbacks.add(f, NULL, userData, policy);
 }
 
 void
 Manip::removeMotionCallback(ManipCB *f, void *userData)
 {
-  vector<CallbackInfo>::iterator iter = motionCallbacks.begin();
-  while (iter != motionCallbacks.end())
+  motionCallbacks.remove(motionCallbacks.find(f, NULL, userData));
+}
+
+ManipCallbackHandle
+Manip::addWorkerMotionCallback(ManipStateCB *f, void *userData)
+{
+  if (f == NULL)
     {
-      CallbackInfo &info = *iter;
-      if ((info.first == f) && (info.second == userData))
-	{
-	  motionCallbacks.erase(iter);
-	  return;
-	}
+      cerr << "Manip::addWorkerMotionCallback: ERROR: detected NULL "
+	   << "callback function." << endl;
+      return 0;
+    }
+  return motionCallbacks.add(NULL, f, userData, IMMEDIATE);
+}
+
+void
+Manip::removeWorkerMotionCallback(ManipStateCB *f, void *userData)
+{
+  removeCallback(motionCallbacks.find(NULL, f, userData));
+}
+
+bool
+Manip::removeCallback(ManipCallbackHandle handle)
+{
+  ManipCallbackList::Entry entry;
+  if (!motionCallbacks.remove(handle, &entry))
+    return false;
+  cancelWorkerCall(entry);
+  return true;
+}
+
+int
+Manip::removeCallbacks(void *userData)
+{
+  vector<ManipCallbackList::Entry> removed;
+  int numRemoved = motionCallbacks.removeAll(userData, &removed);
+  for (int i = 0; i < removed.size(); i++)
+    cancelWorkerCall(removed[i]);
+  return numRemoved;
+}
+
+void
+Manip::getState(ManipState &state) const
+{
+}
+
+void
+Manip::setScreenSize(float pixels)
+{
+  if (pixels < 0)
+    pixels = 0;
+  if (pixels == screenSize)
+    return;
+  screenSize = pixels;
+  ManipManager::getManipManager()->invalidateScreenScales();
+}
+
+float
+Manip::getScreenSize() const
+{
+  return screenSize;
+}
+
+void
+Manip::placementChanged()
+{
+  if (screenSize > 0)
+    ManipManager::getManipManager()->invalidateScreenScales();
+}
+
+Manip::DetailLevel
+Manip::getCoarsestDetailLevel() const
+{
+  return FULL_DETAIL;
+}
+
+void
+Manip::setDetailLevel(DetailLevel level)
+{
+  detailLevel = level;
+}
+
+Manip::DetailLevel
+Manip::getDetailLevel() const
+{
+  return detailLevel;
+}
+
+bool
+Manip::setTargets(const ManipTargets *targets)
+{
+  this->targets = NULL;
+  if (targets == NULL)
+    return true;
+  ManipState state;
+  getState(state);
+  state.getMatrix(targetsBaseInverse);
+  if (!targetsBaseInverse.invertAffine())
+    {
+      cerr << "Manip::setTargets: ERROR: manipulator's transform is singular."
+	   << endl;
+      return false;
+    }
+  this->targets = targets;
+  return true;
+}
+
+const ManipTargets *
+Manip::getTargets() const
+{
+  return targets;
+}
+
+void
+Manip::updateTargets()
+{
+  if ((targets == NULL) || (targets->count == 0))
+    return;
+  GLEEM_TRACE_SCOPE("Manip::updateTargets", this);
+  TargetsJob job;
+  job.targets = targets;
+  ManipState state;
+  getState(state);
+  GleemMat4f cur;
+  state.getMatrix(cur);
+  GleemMat4f::mult(cur, targetsBaseInverse, job.xform);
+  TaskPool *pool = ManipManager::getManipManager()->getTargetPool();
+  if ((pool == NULL) || (targets->count < MIN_PARALLEL_TARGETS))
+    {
+      targets->apply(job.xform, 0, targets->count);
+      return;
     }
+  // One chunk per thread, including this one, rounded up to a whole
+  // number of SSE blocks
+  int numChunks = pool->getNumThreads() + 1;
+  job.chunkSize = (((targets->count + numChunks - 1) / numChunks) + 3) & ~3;
+  numChunks = (targets->count + job.chunkSize - 1) / job.chunkSize;
+  pool->run(&Manip::updateTargetsChunk, &job, numChunks);
+}
+
+void
+Manip::updateTargetsChunk(void *arg, int index)
+{
+  TargetsJob *job = (TargetsJob *) arg;
+  int begin = index * job->chunkSize;
+  int end = begin + job->chunkSize;
+  if (end > job->targets->count)
+    end = job->targets->count;
+  job->targets->apply(job->xform, begin, end);
 }
 
 Manip::Manip()
 {
-  ManipManager::getManipManager()->addManipToWindow(this, glutGetWindow());
+  // Manips constructed on other threads are registered with
+  // ManipManager::queueManipForWindow() once they are complete
+  ManipManager *manager = ManipManager::getManipManager();
+  usePartArena = manager->getPartArenasEnabled();
+  partArena = NULL;
+  partTable = NULL;
+  detailLevel = FULL_DETAIL;
+  screenSize = 0;
+  frameCallbacksPending = false;
+  targets = NULL;
+  if (manager->isOwningThread())
+    manager->addManipToWindow(this, manager->getWindowForNewManip());
 }
 
 Manip::~Manip()
 {
-  ManipManager::getManipManager()->removeManip(this);
+  // A manip can only be known to the manager if it is being deleted
+  // on the owning thread (see ManipManager::init())
+  ManipManager *manager = ManipManager::getManipManager();
+  if (manager->isOwningThread())
+    manager->removeManip(this);
+  if (motionCallbacks.getNumStateCallbacks() > 0)
+    manager->getCallbackWorker()->cancel(this);
+  // Unregisters any parts which outlive the manip, such as geometry
+  // supplied by the application
+  delete partTable;
+  delete partArena;
 }
 
 void
 Manip::drag(const GleemV3f &rayStart,
 	    const GleemV3f &rayDirection)
 {
-  for (int i = 0; i < motionCallbacks.size(); i++)
-    (*motionCallbacks[i].first)(motionCallbacks[i].second, this);
+  updateTargets();
+  // Entries added by the callbacks are not called until the next
+  // drag, and removed ones are skipped
+  ManipManager *manager = ManipManager::getManipManager();
+  bool deferred = false;
+  bool haveState = false;
+  ManipState state;
+  motionCallbacks.beginDispatch();
+  int numEntries = motionCallbacks.getNumEntries();
+  for (int i = 0; i < numEntries; i++)
+    {
+      // Copy, since callbacks may add entries and move the list
+      ManipCallbackList::Entry entry = motionCallbacks.getEntry(i);
+      if (!entry.live)
+	continue;
+      if (entry.stateF != NULL)
+	{
+	  if (!haveState)
+	    {
+	      getState(state);
+	      haveState = true;
+	    }
+	  manager->getCallbackWorker()->post(entry.stateF, entry.userData,
+					     this, state);
+	}
+      else if (entry.policy != IMMEDIATE)
+	deferred = true;
+      else
+	{
+	  GLEEM_TRACE_SCOPE("Manip::motionCallback", entry.userData);
+	  (*entry.f)(entry.userData, this);
+	}
+    }
+  motionCallbacks.endDispatch();
+  if (deferred && !frameCallbacksPending)
+    {
+      frameCallbacksPending = true;
+      manager->queueFrameCallbacks(this);
+    }
+}
+
+void
+Manip::dispatchFrameCallbacks()
+{
+  frameCallbacksPending = false;
+  motionCallbacks.beginDispatch();
+  int numEntries = motionCallbacks.getNumEntries();
+  for (int i = 0; i < numEntries; i++)
+    {
+      ManipCallbackList::Entry entry = motionCallbacks.getEntry(i);
+      if (!entry.live || (entry.f == NULL) ||
+	  (entry.policy != ONCE_PER_FRAME))
+	continue;
+      GLEEM_TRACE_SCOPE("Manip::motionCallback", entry.userData);
+      (*entry.f)(entry.userData, this);
+    }
+  motionCallbacks.endDispatch();
+}
+
+void
+Manip::cancelWorkerCall(const ManipCallbackList::Entry &entry)
+{
+  if (entry.stateF != NULL)
+    ManipManager::getManipManager()->getCallbackWorker()->
+      cancel(this, entry.stateF, entry.userData);
+}
+
+ManipPartArena *
+Manip::getPartArena()
+{
+  if (usePartArena && (partArena == NULL))
+    partArena = new ManipPartArena();
+  return partArena;
+}
+
+void
+Manip::resetPartArena()
+{
+  if (partArena != NULL)
+    partArena->reset();
+}
+
+ManipPartTable *
+Manip::getPartTable()
+{
+  if (partTable == NULL)
+    partTable = new ManipPartTable();
+  return partTable;
+}
+
+ManipPartTable *
+Manip::getActivePartTable()
+{
+  if ((partTable != NULL) && partTable->isValid() &&
+      ManipManager::getManipManager()->getPartTablesEnabled())
+    return partTable;
+  return NULL;
+}
+
+bool
+Manip::getBoundingSphere(BSphere &bsph)
+{
+  return false;
+}
+
+bool
+Manip::intersectFrustum(const Frustum &frustum)
+{
+  BSphere bsph;
+  if (!getBoundingSphere(bsph))
+    return false;
+  return frustum.intersectsSphere(bsph);
 }
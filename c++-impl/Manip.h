@@ -13,6 +13,9 @@
 #include <gleem/Util.h>
 #include <gleem/HitPoint.h>
 #include <gleem/ManipPart.h>
+#include <gleem/ManipState.h>
+#include <gleem/ManipCallbackList.h>
+#include <gleem/ManipTargets.h>
 #include <gleem/Linalg.h>
 
 GLEEM_ENTER_NAMESPACE
@@ -22,23 +25,119 @@ GLEEM_ENTER_NAMESPACE
     understand what to do when that ray cast actually made the
     manipulator active. */
 
-typedef void ManipCB(void *userData, Manip *manip);
-
 class GLEEMDLL Manip
 {
 public:
-  /** These get called each time the manipulator is dragged. Adding a
-      callback twice (even with the same userData) will cause it to
-      get called twice. */
-  void    addMotionCallback(ManipCB *f, void *userData = NULL);
-  /** Removes first instance of (callback, userData) pair, if any. */
+  /** When motion callbacks registered with addMotionCallback() are
+      called */
+  enum CallbackPolicy
+  {
+    /** From within each drag (the default) */
+    IMMEDIATE,
+    /** Once per frame, from ManipManager::render() before any
+        manipulators are drawn, if the manipulator has been dragged
+        since the last frame. The callback sees the latest state. */
+    ONCE_PER_FRAME
+  };
+
+  /** Levels of detail at which a manipulator may be drawn and
+      picked, chosen by the ManipManager from its size on screen (see
+      ManipManager::setDetailThresholds()) */
+  enum DetailLevel
+  {
+    /** All of the manipulator's geometry */
+    FULL_DETAIL,
+    /** An outline of the manipulator's extent, pickable only in the
+	simplest way, such as for translation */
+    BOX_DETAIL,
+    /** A single point, which is not pickable */
+    POINT_DETAIL
+  };
+
+  /** These get called each time the manipulator is dragged, or once
+      per frame in which it was dragged, according to policy. Adding
+      a callback twice (even with the same userData) will cause it to
+      get called twice. Returns a handle for removeCallback(), or 0 if
+      f is NULL. */
+  ManipCallbackHandle addMotionCallback(ManipCB *f, void *userData = NULL,
+					CallbackPolicy policy = IMMEDIATE);
+  /** Removes first instance of (callback, userData) pair, if any.
+      Takes time proportional to the number of callbacks; prefer
+      removeCallback(). */
   void removeMotionCallback(ManipCB *f, void *userData = NULL);
 
+  /** These get called on the ManipManager's callback worker thread
+      each time the manipulator is dragged, with a copy of its state
+      (see getState()) taken during the drag, so that listeners which
+      are too expensive to run within the drag do not slow it down.
+      If the worker has not yet started a call when the manipulator
+      is dragged again, the call gets the newer state instead; see
+      ManipCallbackWorker. Adding a callback twice (even with the same
+      userData) will cause it to get called twice. Returns a handle
+      for removeCallback(), or 0 if f is NULL. */
+  ManipCallbackHandle addWorkerMotionCallback(ManipStateCB *f,
+					      void *userData = NULL);
+  /** Removes first instance of (callback, userData) pair, if any, and
+      drops its waiting call. A call which has already started may
+      still be running; see ManipManager::waitForWorkerCallbacks(). */
+  void removeWorkerMotionCallback(ManipStateCB *f, void *userData = NULL);
+
+  /** Removes the callback registered under the given handle, of
+      either kind, in constant time. Returns false if the handle is
+      stale. Callbacks may be added and removed from within motion
+      callbacks. */
+  bool removeCallback(ManipCallbackHandle handle);
+
+  /** Removes every callback, of either kind, registered with the
+      given userData, and returns how many there were */
+  int removeCallbacks(void *userData);
+
+  /** Fills in the fields of state which apply to this manipulator.
+      The default implementation leaves them all at their defaults. */
+  virtual void getState(ManipState &state) const;
+
+  /** Binds the transforms of the objects this manipulator moves.
+      From then on each drag sets every target's dst transform to
+      D * src, where D is the manipulator's motion since this call:
+      its current transform (see ManipState::getMatrix()) times the
+      inverse of its transform at the time of the call. D is computed
+      once per drag and applied to all of the targets in one loop,
+      spread over the ManipManager's target threads if there are many
+      (see ManipManager::setTargetThreads()), before any motion
+      callbacks are called. Bind again whenever the set of targets or
+      their src transforms change. The ManipTargets and its arrays
+      belong to the caller and must stay valid until they are
+      replaced or setTargets(NULL) is called. Returns false, leaving
+      no targets bound, if the manipulator's transform is singular
+      (for example, scaled to zero). */
+  bool setTargets(const ManipTargets *targets);
+  /** Returns the bound targets, or NULL */
+  const ManipTargets *getTargets() const;
+
+  /** Brings the bound targets up to date with the manipulator's
+      state. drag() does this; call it after setting the state
+      directly, with setTranslation() and the like. */
+  void updateTargets();
+
+  /** Keeps this manipulator about the given number of pixels across
+      on screen at any distance from the camera, measured by its
+      bounding sphere (see getBoundingSphere()). The ManipManager
+      scales it about its translation (see getState()), as changing
+      its geometry scale would, by a factor computed for each window
+      when that window's camera parameters are updated or the
+      manipulator moves, and applies the factor when rendering and
+      picking, so that the manipulator's geometry is never rebuilt.
+      Manipulators without bounds are not scaled. 0, the default,
+      turns this off. */
+  void setScreenSize(float pixels);
+  float getScreenSize() const;
+
 GLEEM_INTERNAL public:
   Manip();
   virtual ~Manip();
 
-  /** Render this manipulator using OpenGL */
+  /** Render this manipulator using OpenGL, at the level of detail
+      given by getDetailLevel() */
   virtual void render() = 0;
 
   /** Cast a ray in 3-space from the camera start position in the
@@ -51,6 +150,21 @@ GLEEM_INTERNAL public:
 			    const GleemV3f &rayDirection,
 			    vector<HitPoint> &results) = 0;
 
+  /** Returns the coarsest level of detail this manipulator can
+      render and pick at; the ManipManager never chooses a coarser
+      one. At BOX_DETAIL the ManipManager calls intersectRay() rather
+      than picking against the part table, and at POINT_DETAIL it
+      does not pick the manipulator at all. The default returns
+      FULL_DETAIL, so that manipulators which know nothing of levels
+      of detail are always drawn and picked in full. */
+  virtual DetailLevel getCoarsestDetailLevel() const;
+
+  /** The level of detail at which render() and intersectRay() should
+      work. The ManipManager sets it before rendering or picking the
+      manipulator in each window. */
+  void setDetailLevel(DetailLevel level);
+  DetailLevel getDetailLevel() const;
+
   /** Tell the manipulator to highlight the current portion of itself.
       This is merely visual feedback to the user. */
   virtual void highlight(const HitPoint &hit) = 0;
@@ -80,9 +194,98 @@ GLEEM_INTERNAL public:
       drag. */
   virtual void makeInactive() = 0;
 
+  /** Compute a world-space bounding sphere enclosing all of the
+      pickable geometry of this manipulator. The ManipManager uses it
+      to skip intersectRay() for rays which can not hit the
+      manipulator. Returns false if bounds are unavailable, in which
+      case intersectRay() is always called. The default
+      implementation returns false. */
+  virtual bool getBoundingSphere(BSphere &bsph);
+
+  /** Returns true if any pickable portion of this manipulator lies
+      within the given frustum. Used for marquee selection. The
+      default implementation tests the bounding sphere from
+      getBoundingSphere() and returns false if there is none;
+      manipulators made of several separated parts should test them
+      individually. */
+  virtual bool intersectFrustum(const Frustum &frustum);
+
+  /** Returns this manipulator's part table if it has published one,
+      it is currently valid and part tables are enabled in the
+      ManipManager, otherwise NULL. The ManipManager then picks
+      against the table instead of calling intersectRay() and
+      intersectFrustum(), and subclasses should render and transform
+      their parts through it. */
+  ManipPartTable *getActivePartTable();
+
+  /** Calls the ONCE_PER_FRAME motion callbacks. Called by the
+      ManipManager once per frame in which this manipulator was
+      dragged. */
+  void dispatchFrameCallbacks();
+
+protected:
+  /** Arena from which subclasses should allocate the ManipParts they
+      own, with new (getPartArena()), so that a manipulator's geometry
+      is contiguous in memory. It is created on first use and
+      destroyed after the subclass destructor has run. Returns NULL,
+      meaning the heap, if part arenas were disabled in the
+      ManipManager when this manipulator was constructed. */
+  ManipPartArena *getPartArena();
+
+  /** Reclaims all memory in the part arena. All parts allocated from
+      it must already have been deleted. */
+  void resetPartArena();
+
+  /** Table into which subclasses should publish the ManipParts their
+      intersectRay() tests, with ManipPartTable::addPickRoot(), so
+      that the ManipManager can pick against them in one loop, and
+      any others they render, with addRenderRoot(). The subclass
+      promises that picking against the table's pick roots is the
+      same as calling its intersectRay() and intersectFrustum().
+      It is created on first use. Destroying or restructuring any of
+      the published parts empties the table, so it must be rebuilt
+      whenever the geometry is. */
+  ManipPartTable *getPartTable();
+
+  /** Subclasses must call this whenever their translation or bounds
+      change, for example from the function which rebuilds their
+      transform, so that a manipulator kept at a screen size (see
+      setScreenSize()) is rescaled about its new position. Cheap, and
+      does nothing unless a screen size is set. */
+  void placementChanged();
+
 private:
-  typedef pair<ManipCB *, void *> CallbackInfo;
-  vector<CallbackInfo> motionCallbacks;
+  bool usePartArena;
+  ManipPartArena *partArena;
+  ManipPartTable *partTable;
+  DetailLevel detailLevel;
+  float screenSize;
+
+  /** Drops the waiting worker call of a removed callback, if any */
+  void cancelWorkerCall(const ManipCallbackList::Entry &entry);
+
+  ManipCallbackList motionCallbacks;
+
+  enum
+  {
+    /** Fewer targets than this are updated on the calling thread
+        alone */
+    MIN_PARALLEL_TARGETS = 16384
+  };
+  const ManipTargets *targets;
+  /** Inverse of the manipulator's transform when targets were bound */
+  GleemMat4f targetsBaseInverse;
+
+  class TargetsJob
+  {
+  public:
+    const ManipTargets *targets;
+    GleemMat4f xform;
+    int chunkSize;
+  };
+  static void updateTargetsChunk(void *arg, int index);
+  /** True if queued with the ManipManager for dispatchFrameCallbacks() */
+  bool frameCallbacksPending;
 };
 
 GLEEM_EXIT_NAMESPACE
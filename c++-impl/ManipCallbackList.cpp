@@ -0,0 +1,186 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <assert.h>
+#include <iostream.h>
+#include <gleem/ManipCallbackList.h>
+
+GLEEM_USE_NAMESPACE
+
+ManipCallbackList::ManipCallbackList()
+{
+  numDead = 0;
+  numStateCallbacks = 0;
+  dispatchDepth = 0;
+}
+
+ManipCallbackHandle
+ManipCallbackList::add(ManipCB *f, ManipStateCB *stateF,
+		       void *userData, int policy)
+{
+  int slot;
+  if (freeSlots.size() > 0)
+    {
+      slot = freeSlots.back();
+      freeSlots.pop_back();
+    }
+  else
+    {
+      slot = slots.size();
+      if (slot >= SLOT_MASK)
+	{
+	  cerr << "gleem::ManipCallbackList::add: ERROR: too many callbacks"
+	       << endl;
+	  return 0;
+	}
+      Slot newSlot;
+      newSlot.generation = 0;
+      slots.push_back(newSlot);
+    }
+  Entry entry;
+  entry.f = f;
+  entry.stateF = stateF;
+  entry.userData = userData;
+  entry.policy = policy;
+  entry.live = true;
+  entry.slot = slot;
+  slots[slot].entry = entries.size();
+  entries.push_back(entry);
+  if (stateF != NULL)
+    ++numStateCallbacks;
+  return ((slots[slot].generation << SLOT_BITS) |
+	  (unsigned long) (slot + 1));
+}
+
+bool
+ManipCallbackList::remove(ManipCallbackHandle handle, Entry *entry)
+{
+  int slot = lookup(handle);
+  if (slot < 0)
+    return false;
+  int index = slots[slot].entry;
+  if (entry != NULL)
+    *entry = entries[index];
+  removeEntry(index);
+  compactIfNeeded();
+  return true;
+}
+
+ManipCallbackHandle
+ManipCallbackList::find(ManipCB *f, ManipStateCB *stateF,
+			void *userData) const
+{
+  for (int i = 0; i < entries.size(); i++)
+    {
+      const Entry &entry = entries[i];
+      if (entry.live && (entry.f == f) && (entry.stateF == stateF) &&
+	  (entry.userData == userData))
+	{
+	  const Slot &slot = slots[entry.slot];
+	  return ((slot.generation << SLOT_BITS) |
+		  (unsigned long) (entry.slot + 1));
+	}
+    }
+  return 0;
+}
+
+int
+ManipCallbackList::removeAll(void *userData, vector<Entry> *removed)
+{
+  int numRemoved = 0;
+  for (int i = 0; i < entries.size(); i++)
+    {
+      if (entries[i].live && (entries[i].userData == userData))
+	{
+	  if (removed != NULL)
+	    removed->push_back(entries[i]);
+	  removeEntry(i);
+	  ++numRemoved;
+	}
+    }
+  compactIfNeeded();
+  return numRemoved;
+}
+
+int
+ManipCallbackList::getNumEntries() const
+{
+  return entries.size();
+}
+
+const ManipCallbackList::Entry &
+ManipCallbackList::getEntry(int i) const
+{
+  return entries[i];
+}
+
+int
+ManipCallbackList::getNumStateCallbacks() const
+{
+  return numStateCallbacks;
+}
+
+void
+ManipCallbackList::beginDispatch()
+{
+  ++dispatchDepth;
+}
+
+void
+ManipCallbackList::endDispatch()
+{
+  assert(dispatchDepth > 0);
+  --dispatchDepth;
+  compactIfNeeded();
+}
+
+int
+ManipCallbackList::lookup(ManipCallbackHandle handle) const
+{
+  int slot = (int) (handle & SLOT_MASK) - 1;
+  if ((slot < 0) || (slot >= slots.size()))
+    return -1;
+  const Slot &info = slots[slot];
+  if ((info.entry < 0) ||
+      (info.generation != ((handle >> SLOT_BITS) & GENERATION_MASK)))
+    return -1;
+  return slot;
+}
+
+void
+ManipCallbackList::removeEntry(int index)
+{
+  Entry &entry = entries[index];
+  assert(entry.live);
+  entry.live = false;
+  if (entry.stateF != NULL)
+    --numStateCallbacks;
+  ++numDead;
+  // Retire the handle now; only the entry waits for compaction
+  Slot &slot = slots[entry.slot];
+  slot.entry = -1;
+  slot.generation = (slot.generation + 1) & GENERATION_MASK;
+  freeSlots.push_back(entry.slot);
+}
+
+void
+ManipCallbackList::compactIfNeeded()
+{
+  if ((dispatchDepth > 0) || (numDead <= entries.size() - numDead))
+    return;
+  int dest = 0;
+  for (int i = 0; i < entries.size(); i++)
+    {
+      if (!entries[i].live)
+	continue;
+      if (dest != i)
+	entries[dest] = entries[i];
+      slots[entries[dest].slot].entry = dest;
+      ++dest;
+    }
+  entries.erase(entries.begin() + dest, entries.end());
+  numDead = 0;
+}
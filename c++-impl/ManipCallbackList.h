@@ -0,0 +1,123 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_MANIP_CALLBACK_LIST_H
+#define _GLEEM_MANIP_CALLBACK_LIST_H
+
+#include <vector.h>
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+#include <gleem/ManipState.h>
+
+GLEEM_ENTER_NAMESPACE
+
+class Manip;
+
+typedef void ManipCB(void *userData, Manip *manip);
+
+/** Identifies one registration of a motion callback; see
+    Manip::addMotionCallback(). Zero is never a valid handle. A handle
+    stays valid until its callback is removed, after which it refers
+    to nothing; handles are only reused after a slot has been
+    recycled several thousand times. */
+typedef unsigned long ManipCallbackHandle;
+
+/** A manipulator's motion callbacks, in registration order. Adding
+    and removing by handle take constant time. Removal only marks an
+    entry dead; dead entries are compacted away once they outnumber
+    the live ones, but never while the list is being dispatched, so
+    callbacks may add and remove callbacks (including themselves)
+    while they run. Entries added during a dispatch are not called
+    until the next one. */
+
+GLEEM_INTERNAL class GLEEMDLL ManipCallbackList
+{
+public:
+  class Entry
+  {
+  public:
+    /** Exactly one of f and stateF is non-NULL */
+    ManipCB *f;
+    ManipStateCB *stateF;
+    void *userData;
+    int policy;
+    bool live;
+
+  private:
+    friend class ManipCallbackList;
+    /** Index into slots */
+    int slot;
+  };
+
+  ManipCallbackList();
+
+  ManipCallbackHandle add(ManipCB *f, ManipStateCB *stateF,
+			  void *userData, int policy);
+
+  /** Returns false if the handle is zero or stale. If entry is not
+      NULL, a copy of the removed entry is stored there. */
+  bool remove(ManipCallbackHandle handle, Entry *entry = NULL);
+
+  /** Returns the handle of the first live entry with the given
+      callback and userData, or 0 if there is none */
+  ManipCallbackHandle find(ManipCB *f, ManipStateCB *stateF,
+			   void *userData) const;
+
+  /** Removes every entry with the given userData, appending copies
+      of them to removed if it is not NULL. Returns the number
+      removed. */
+  int removeAll(void *userData, vector<Entry> *removed = NULL);
+
+  /** Entries, including dead ones, are numbered 0..getNumEntries() -
+      1 in registration order; only call the live ones */
+  int getNumEntries() const;
+  const Entry &getEntry(int i) const;
+
+  /** Number of live entries with a stateF */
+  int getNumStateCallbacks() const;
+
+  /** Bracket a pass over the entries during which callbacks may
+      modify the list */
+  void beginDispatch();
+  void endDispatch();
+
+private:
+  enum
+  {
+    // A handle is the slot index plus one in its low bits and the
+    // slot's generation above them
+    SLOT_BITS = 20,
+    SLOT_MASK = (1 << SLOT_BITS) - 1,
+    GENERATION_MASK = (1 << (32 - SLOT_BITS)) - 1
+  };
+
+  class Slot
+  {
+  public:
+    /** Index into entries, or -1 if the slot is free */
+    int entry;
+    unsigned long generation;
+  };
+
+  /** Slot index of a live handle, or -1 */
+  int lookup(ManipCallbackHandle handle) const;
+  void removeEntry(int index);
+  /** Drops dead entries if they outnumber the live ones and no
+      dispatch is in progress */
+  void compactIfNeeded();
+
+  vector<Entry> entries;
+  vector<Slot> slots;
+  vector<int> freeSlots;
+  int numDead;
+  int numStateCallbacks;
+  int dispatchDepth;
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_MANIP_CALLBACK_LIST_H
@@ -0,0 +1,142 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <gleem/ManipCallbackWorker.h>
+#include <gleem/Trace.h>
+
+GLEEM_USE_NAMESPACE
+
+ManipCallbackWorker::ManipCallbackWorker()
+{
+  busy = false;
+  quitting = false;
+  thread = Thread::startJoinable(&ManipCallbackWorker::threadMain, this);
+}
+
+ManipCallbackWorker::~ManipCallbackWorker()
+{
+  if (thread == NULL)
+    return;
+  mutex.lock();
+  quitting = true;
+  mutex.unlock();
+  workReady.set();
+  // Joining rather than waiting on an event ensures the thread is
+  // done with the mutex and events before they are destroyed
+  Thread::join(thread);
+}
+
+void
+ManipCallbackWorker::post(ManipStateCB *f, void *userData, Manip *manip,
+			  const ManipState &state)
+{
+  if (thread == NULL)
+    {
+      GLEEM_TRACE_SCOPE("Manip::workerMotionCallback", userData);
+      (*f)(userData, manip, state);
+      return;
+    }
+  mutex.lock();
+  bool wasEmpty = (calls.size() == 0);
+  int i;
+  for (i = 0; i < calls.size(); i++)
+    {
+      Call &call = calls[i];
+      if ((call.f == f) && (call.userData == userData) &&
+	  (call.manip == manip))
+	{
+	  call.state = state;
+	  break;
+	}
+    }
+  if (i == calls.size())
+    {
+      Call call;
+      call.f = f;
+      call.userData = userData;
+      call.manip = manip;
+      call.state = state;
+      calls.push_back(call);
+    }
+  mutex.unlock();
+  if (wasEmpty)
+    workReady.set();
+}
+
+void
+ManipCallbackWorker::cancel(Manip *manip, ManipStateCB *f, void *userData)
+{
+  mutex.lock();
+  int dest = 0;
+  for (int i = 0; i < calls.size(); i++)
+    {
+      Call &call = calls[i];
+      if ((call.manip == manip) &&
+	  ((f == NULL) || ((call.f == f) && (call.userData == userData))))
+	continue;
+      if (dest != i)
+	calls[dest] = call;
+      ++dest;
+    }
+  calls.erase(calls.begin() + dest, calls.end());
+  mutex.unlock();
+}
+
+void
+ManipCallbackWorker::waitUntilIdle()
+{
+  if (thread == NULL)
+    return;
+  while (true)
+    {
+      mutex.lock();
+      bool done = ((calls.size() == 0) && !busy);
+      mutex.unlock();
+      if (done)
+	return;
+      idle.wait();
+    }
+}
+
+void
+ManipCallbackWorker::threadMain(void *arg)
+{
+  ((ManipCallbackWorker *) arg)->run();
+}
+
+void
+ManipCallbackWorker::run()
+{
+  mutex.lock();
+  while (!quitting)
+    {
+      if (calls.size() == 0)
+	{
+	  busy = false;
+	  mutex.unlock();
+	  idle.set();
+	  workReady.wait();
+	  mutex.lock();
+	  continue;
+	}
+      // Take the oldest call only. Removing it under the lock means
+      // cancel() either drops it or finds it already started. A new
+      // state posted for it while it runs is queued behind the calls
+      // still waiting.
+      busy = true;
+      Call call = calls[0];
+      calls.erase(calls.begin());
+      mutex.unlock();
+      {
+	GLEEM_TRACE_SCOPE("Manip::workerMotionCallback", call.userData);
+	(*call.f)(call.userData, call.manip, call.state);
+      }
+      mutex.lock();
+    }
+  busy = false;
+  mutex.unlock();
+  idle.set();
+}
@@ -0,0 +1,88 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_MANIP_CALLBACK_WORKER_H
+#define _GLEEM_MANIP_CALLBACK_WORKER_H
+
+#include <vector.h>
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+#include <gleem/Thread.h>
+#include <gleem/ManipState.h>
+
+GLEEM_ENTER_NAMESPACE
+
+/** A thread which runs motion callbacks registered with
+    Manip::addWorkerMotionCallback(), so that expensive listeners do
+    not hold up the drag which triggered them. Calls are coalesced:
+    each (callback, userData, manipulator) combination has at most one
+    call waiting, carrying the most recent state, so a listener which
+    falls behind skips intermediate states rather than building up a
+    backlog. Calls run in the order their combinations were first
+    queued. If the thread can not be started (for example when
+    compiled with GLEEM_NO_THREADS), calls are made immediately on the
+    calling thread instead. */
+
+GLEEM_INTERNAL class GLEEMDLL ManipCallbackWorker
+{
+public:
+  ManipCallbackWorker();
+  /** Waits for the worker thread to finish the call in progress and
+      exit. Calls still waiting are dropped. */
+  ~ManipCallbackWorker();
+
+  /** Queues a call of f(userData, manip, state), replacing the state
+      of the same combination's call if one is already waiting */
+  void post(ManipStateCB *f, void *userData, Manip *manip,
+	    const ManipState &state);
+
+  /** Drops the waiting calls for the given manipulator, or only those
+      of (f, userData) for it if f is not NULL. The worker takes calls
+      off the queue one at a time, so only a call which has already
+      started may still be running when this returns; see
+      waitUntilIdle(). */
+  void cancel(Manip *manip, ManipStateCB *f = NULL, void *userData = NULL);
+
+  /** Blocks until no calls are waiting or running */
+  void waitUntilIdle();
+
+private:
+  // Not copyable
+  ManipCallbackWorker(const ManipCallbackWorker &);
+  ManipCallbackWorker &operator=(const ManipCallbackWorker &);
+
+  class Call
+  {
+  public:
+    ManipStateCB *f;
+    void *userData;
+    Manip *manip;
+    ManipState state;
+  };
+
+  static void threadMain(void *arg);
+  void run();
+
+  /** Protects everything below it */
+  Mutex mutex;
+  vector<Call> calls;
+  /** True while the worker thread is making calls */
+  bool busy;
+  bool quitting;
+
+  /** NULL if the thread could not be started */
+  Thread::Handle thread;
+
+  /** Set when calls are queued or the worker should quit */
+  Event workReady;
+  /** Set when the worker thread finds no calls waiting */
+  Event idle;
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_MANIP_CALLBACK_WORKER_H
@@ -12,22 +12,79 @@
 #include <iostream.h>
 #include <algo.h>
 #include <gleem/ManipManager.h>
+#include <gleem/ManipCallbackWorker.h>
+#include <gleem/TaskPool.h>
+#include <gleem/Atomic.h>
 #include <gleem/RightTruncPyrMapping.h>
 #include <gleem/Manip.h>
+#include <gleem/ManipPartTable.h>
+#include <gleem/MathUtil.h>
+#include <gleem/Trace.h>
 
 GLEEM_USE_NAMESPACE
 
+#ifdef GLEEM_ENABLE_STATS
+// Points ManipStats::current at a window's counters for the duration
+// of an event or render, then restores the previous target
+class StatsWindowScope
+{
+public:
+  StatsWindowScope(ManipStats *stats)
+  {
+    prev = ManipStats::current;
+    if (stats != NULL)
+      ManipStats::current = stats;
+  }
+  ~StatsWindowScope()
+  {
+    ManipStats::current = prev;
+  }
+
+private:
+  ManipStats *prev;
+};
+# define GLEEM_STATS_WINDOW_SCOPE(windowID) \
+  StatsWindowScope _gleemStatsScope(getFrameStats(windowID))
+# define GLEEM_STATS_START_EVENT(windowID) \
+  startStatsEvent(windowID, Clock::nanoTime())
+# define GLEEM_STATS_END_FRAME(windowID) endStatsFrame(windowID)
+#else
+# define GLEEM_STATS_START_EVENT(windowID)
+# define GLEEM_STATS_WINDOW_SCOPE(windowID)
+# define GLEEM_STATS_END_FRAME(windowID)
+#endif
+
 static const int MANIP_MANAGER_NUM_WINDOWS = 16; // How many windows do we
 						 // expect to be created?
 static const int MANIP_MANAGER_NUM_MANIPS = 32; // How many manipulators do we
 						// expect to be created?
+static const int MANIP_MANAGER_PICK_PACKET_SIZE = 16; // Rays per packet in
+						      // pickRays()
+static const int MANIP_MANAGER_PICK_DIR_CELLS = 16; // Direction quantization
+						    // for sorting rays
+static const int MANIP_MANAGER_MAX_PENDING_EVENTS = 1024; // Events per window
+							  // timed between
+							  // renders
+
+static bool
+sameCameraParameters(const CameraParameters &a, const CameraParameters &b)
+{
+  return ((a.position == b.position) &&
+	  (a.forwardDirection == b.forwardDirection) &&
+	  (a.upDirection == b.upDirection) &&
+	  (a.vertFOV == b.vertFOV) &&
+	  (a.imagePlaneAspectRatio == b.imagePlaneAspectRatio) &&
+	  (a.xSize == b.xSize) &&
+	  (a.ySize == b.ySize));
+}
+
 size_t
 ManipManager::hashManip(const Manip * const &arg)
 {
   return (int) ((void *) arg);
 }
 
-ManipManager *ManipManager::manipManager = NULL;
+ManipManager * volatile ManipManager::manipManager = NULL;
 
 void
 ManipManager::init(bool install)
@@ -36,33 +93,48 @@ ManipManager::init(bool install)
     {
       cerr << "gleem::ManipManager::init(): (warning/usage) init() called "
 	   << "more than once (error, but continuing)" << endl;
+      return;
     }
-  else
+  ManipManager *newManager = new ManipManager();
+  if (Atomic::compareAndSwapPtr((void * volatile *) &manipManager,
+				NULL, newManager) == false)
     {
-      manipManager = new ManipManager();
-      if (install)
-	manipManager->installGLUTCallbacks(glutGetWindow());
+      // Another thread's init() got there first. Nothing else can
+      // have seen our instance.
+      delete newManager->mapping;
+      delete newManager;
+      return;
     }
+  if (install)
+    manipManager->installGLUTCallbacks(glutGetWindow());
 }
 
 ManipManager *
 ManipManager::getManipManager()
 {
-  if (manipManager == NULL)
+  // The load pairs with the compare-and-swap in init(), so that a
+  // thread other than the one which called init() sees the manager
+  // fully constructed
+  ManipManager *manager =
+    (ManipManager *) Atomic::loadPtr((void * volatile *) &manipManager);
+  if (manager == NULL)
     {
       cerr << "gleem::ManipManager::getManipManager: WARNING: you probably "
 	   << "forgot to call ManipManager::init(), so I'm doing it for you"
 	   << endl;
       init();
+      manager = (ManipManager *)
+	Atomic::loadPtr((void * volatile *) &manipManager);
     }
-  return manipManager;
+  return manager;
 }
 
 void
 ManipManager::updateCameraParameters(int windowID,
 				     const CameraParameters &params)
 {
-  WindowToCameraParametersTable::iterator iter =
+  flushPendingManips();
+  WindowToCameraInfoTable::iterator iter =
     windowCameraTable.find(windowID);
   if (iter == windowCameraTable.end())
     {
@@ -71,13 +143,43 @@ ManipManager::updateCameraParameters(int windowID,
 	   << windowID << ")." << endl
 	   << "You need to call windowCreated() when you open a new window."
 	   << endl;
+      return;
+    }
+  CameraInfo &info = *iter;
+  // Applications typically update the camera every frame; only
+  // changes, to the camera or to the window's mapping, are logged or
+  // cause the basis to be recomputed
+  bool paramsChanged =
+    !(info.paramsValid && sameCameraParameters(info.params, params));
+  if (paramsChanged)
+    {
+      if (eventLog.isWriting())
+	{
+	  EventLog::Event event;
+	  event.type = EventLog::CAMERA;
+	  event.windowID = windowID;
+	  event.params = params;
+	  recordEvent(event);
+	}
+      info.params = params;
+      info.paramsValid = true;
     }
-  *iter = params;
+  ScreenToRayMapping *map = (info.mapping != NULL) ? info.mapping : mapping;
+  if (paramsChanged ||
+      ((map != NULL) && (map->getGeneration() != info.mappingGeneration)))
+    recomputeBasis(info);
+  // The scale factors of all of the window's manipulators in one pass
+  WindowToManipListTable::iterator windowTableIter =
+    windowManipTable.find(windowID);
+  assert(windowTableIter != windowManipTable.end());
+  updateScreenScales(info, *windowTableIter);
 }
 
 void
 ManipManager::render()
 {
+  flushPendingManips();
+  dispatchFrameCallbacks();
   for (WindowToManipListTable::iterator windowTableIter =
 	 windowManipTable.begin();
        windowTableIter != windowManipTable.end();
@@ -87,14 +189,60 @@ ManipManager::render()
       ManipList &manips = *windowTableIter;
       if (glutGetWindow() != windowID)
 	glutSetWindow(windowID);
-      for (int i = 0; i < manips.size(); i++)
-	manips[i]->render();
+      {
+	GLEEM_STATS_WINDOW_SCOPE(windowID);
+	GLEEM_STATS_TIMER(renderNanos);
+	GLEEM_TRACE_SCOPE("ManipManager::render", this);
+	WindowToCameraInfoTable::iterator camIter =
+	  windowCameraTable.find(windowID);
+	assert(camIter != windowCameraTable.end());
+	CameraInfo &camInfo = *camIter;
+	updateScreenScales(camInfo, manips);
+	bool cull = (frustumCullingEnabled && camInfo.basisValid &&
+		     camInfo.affine);
+	BSphere bsph;
+	for (int i = 0; i < manips.size(); i++)
+	  {
+	    Manip *manip = manips[i];
+	    bool haveBounds = manip->getBoundingSphere(bsph);
+	    if (haveBounds)
+	      scaleBounds(camInfo, i, bsph);
+	    if (cull && haveBounds &&
+		!camInfo.viewFrustum.intersectsSphere(bsph))
+	      {
+		GLEEM_STATS_INC(manipsCulled);
+		continue;
+	      }
+	    updateDetailLevel(camInfo, manip, haveBounds, bsph);
+	    GLEEM_STATS_INC(manipsRendered);
+	    GLEEM_TRACE_SCOPE("Manip::render", manip);
+	    float scale = getScreenScale(camInfo, i);
+	    if (scale == 1)
+	      {
+		manip->render();
+		continue;
+	      }
+	    const GleemV3f &center = camInfo.screenScaleCenters[i];
+	    glPushAttrib(GL_ENABLE_BIT | GL_TRANSFORM_BIT);
+	    glEnable(GL_NORMALIZE);
+	    glMatrixMode(GL_MODELVIEW);
+	    glPushMatrix();
+	    glTranslatef(center[0], center[1], center[2]);
+	    glScalef(scale, scale, scale);
+	    glTranslatef(-center[0], -center[1], -center[2]);
+	    manip->render();
+	    glPopMatrix();
+	    glPopAttrib();
+	  }
+      }
+      GLEEM_STATS_END_FRAME(windowID);
     }
 }
 
 bool
 ManipManager::windowCreated(int windowID)
 {
+  flushPendingManips();
   if (findEntryForWindow(windowID) == true)
     return false;
   createEntryForWindow(windowID);
@@ -104,6 +252,7 @@ ManipManager::windowCreated(int windowID)
 bool
 ManipManager::windowDestroyed(int windowID)
 {
+  flushPendingManips();
   if (findEntryForWindow(windowID) == false)
     return false;
   removeEntryForWindow(windowID);
@@ -112,6 +261,14 @@ ManipManager::windowDestroyed(int windowID)
 
 bool
 ManipManager::addManipToWindow(Manip *manip, int windowID)
+{
+  // Keep the order in which manips show up in their windows
+  flushPendingManips();
+  return attachManip(manip, windowID);
+}
+
+bool
+ManipManager::attachManip(Manip *manip, int windowID)
 {
   // Ensure no problems later
   createEntryForManip(manip);
@@ -131,6 +288,7 @@ ManipManager::addManipToWindow(Manip *manip, int windowID)
     }
   // Insert
   manipList.push_back(manip);
+  invalidateScreenScales();
   IntList &windowList = *(manipWindowTable.find(manip));
   assert(find(windowList.begin(), windowList.end(), windowID) ==
 	 windowList.end());
@@ -141,6 +299,7 @@ ManipManager::addManipToWindow(Manip *manip, int windowID)
 bool
 ManipManager::removeManipFromWindow(Manip *manip, int windowID)
 {
+  flushPendingManips();
   WindowToManipListTable::iterator windowTableIter =
     windowManipTable.find(windowID);
   if (windowTableIter == windowManipTable.end())
@@ -151,6 +310,7 @@ ManipManager::removeManipFromWindow(Manip *manip, int windowID)
   if (manipListIter == manipList.end())
     return false;
   manipList.erase(manipListIter);
+  invalidateScreenScales();
   // Okay, now remove window from manip's window list
   ManipToWindowListTable::iterator manipTableIter =
     manipWindowTable.find(manip);
@@ -163,6 +323,447 @@ ManipManager::removeManipFromWindow(Manip *manip, int windowID)
   return true;
 }
 
+int
+ManipManager::pickRays(int windowID,
+		       int numRays,
+		       const GleemV3f *rayStarts,
+		       const GleemV3f *rayDirections,
+		       HitPoint *results)
+{
+  flushPendingManips();
+  WindowToManipListTable::iterator windowTableIter =
+    windowManipTable.find(windowID);
+  if (windowTableIter == windowManipTable.end())
+    {
+      cerr << "gleem::ManipManager::pickRays: ERROR: "
+	   << "I got called with a window I had never heard of ("
+	   << windowID << ")." << endl;
+      return -1;
+    }
+  ManipList &manips = *windowTableIter;
+  WindowToCameraInfoTable::iterator camIter =
+    windowCameraTable.find(windowID);
+  assert(camIter != windowCameraTable.end());
+  CameraInfo &camInfo = *camIter;
+  updateScreenScales(camInfo, manips);
+  GLEEM_STATS_WINDOW_SCOPE(windowID);
+  GLEEM_STATS_TIMER(pickNanos);
+  GLEEM_STATS_ADD(raysCast, numRays);
+  int i, j, k;
+
+  // Sort rays by quantized direction so that each packet of
+  // consecutive rays points in roughly the same direction
+  pickRayOrder.erase(pickRayOrder.begin(), pickRayOrder.end());
+  for (i = 0; i < numRays; i++)
+    {
+      results[i].manipulator = NULL;
+      results[i].manipPart = NULL;
+      GleemV3f dir = rayDirections[i];
+      dir.normalize();
+      int key = 0;
+      for (j = 0; j < 3; j++)
+	{
+	  int cell = (int) ((dir[j] + 1.0f) * 0.5f *
+			    (float) MANIP_MANAGER_PICK_DIR_CELLS);
+	  key = (key * MANIP_MANAGER_PICK_DIR_CELLS) +
+	    GLEEM_CLAMP(cell, 0, MANIP_MANAGER_PICK_DIR_CELLS - 1);
+	}
+      pickRayOrder.push_back(pair<int, int>(key, i));
+    }
+  sort(pickRayOrder.begin(), pickRayOrder.end());
+
+  int numHits = 0;
+  BSphere bsph;
+  for (int packetStart = 0;
+       packetStart < numRays;
+       packetStart += MANIP_MANAGER_PICK_PACKET_SIZE)
+    {
+      int packetEnd = GLEEM_MIN2(packetStart + MANIP_MANAGER_PICK_PACKET_SIZE,
+				 numRays);
+      // If all rays in the packet share an origin (the usual case
+      // for rays generated from a camera), bound them with a cone so
+      // that a manipulator can be rejected for the whole packet with
+      // one test.
+      const GleemV3f &origin = rayStarts[pickRayOrder[packetStart].second];
+      bool useCone = true;
+      GleemV3f coneAxis(0, 0, 0);
+      for (i = packetStart; (i < packetEnd) && useCone; i++)
+	{
+	  int idx = pickRayOrder[i].second;
+	  if (!(rayStarts[idx] == origin))
+	    useCone = false;
+	  GleemV3f dir = rayDirections[idx];
+	  dir.normalize();
+	  coneAxis += dir;
+	}
+      float coneCos = 1.0f;
+      if (useCone)
+	{
+	  if (coneAxis.lengthSquared() == 0.0f)
+	    useCone = false;
+	  else
+	    {
+	      coneAxis.normalize();
+	      for (i = packetStart; i < packetEnd; i++)
+		{
+		  GleemV3f dir = rayDirections[pickRayOrder[i].second];
+		  dir.normalize();
+		  coneCos = GLEEM_MIN2(coneCos, coneAxis.dot(dir));
+		}
+	      // Only bother with reasonably narrow packets
+	      if (coneCos <= 0.0f)
+		useCone = false;
+	    }
+	}
+      float coneSin = sqrtf(GLEEM_MAX2(0.0f, 1.0f - coneCos * coneCos));
+
+      for (j = 0; j < manips.size(); j++)
+	{
+	  Manip *manip = manips[j];
+	  bool haveBounds = manip->getBoundingSphere(bsph);
+	  if (haveBounds)
+	    scaleBounds(camInfo, j, bsph);
+	  updateDetailLevel(camInfo, manip, haveBounds, bsph);
+	  if (manip->getDetailLevel() == Manip::POINT_DETAIL)
+	    continue;
+	  if (haveBounds && useCone)
+	    {
+	      // The sphere subtends a half-angle s as seen from the
+	      // origin; it touches the cone (half-angle c) only if the
+	      // angle between the cone axis and the sphere's center is
+	      // at most c + s.
+	      GleemV3f toCenter = bsph.getCenter() - origin;
+	      float distSq = toCenter.lengthSquared();
+	      float radius = bsph.getRadius();
+	      if (distSq > radius * radius)
+		{
+		  float dist = sqrtf(distSq);
+		  float sphSin = radius / dist;
+		  float sphCos = sqrtf(1.0f - sphSin * sphSin);
+		  if (coneAxis.dot(toCenter) <
+		      dist * (coneCos * sphCos - coneSin * sphSin))
+		    {
+		      GLEEM_STATS_INC(boundRejects);
+		      continue;
+		    }
+		}
+	    }
+	  for (i = packetStart; i < packetEnd; i++)
+	    {
+	      int idx = pickRayOrder[i].second;
+	      const GleemV3f &rayStart = rayStarts[idx];
+	      const GleemV3f &rayDirection = rayDirections[idx];
+	      GLEEM_STATS_INC(manipsVisited);
+	      if (haveBounds && !bsph.hitByRay(rayStart, rayDirection))
+		{
+		  GLEEM_STATS_INC(boundRejects);
+		  continue;
+		}
+	      pickResults.erase(pickResults.begin(), pickResults.end());
+	      intersectManip(camInfo, j, manip, rayStart, rayDirection,
+			     pickResults);
+	      GLEEM_STATS_ADD(hitsProduced, pickResults.size());
+	      HitPoint &best = results[idx];
+	      for (k = 0; k < pickResults.size(); k++)
+		{
+		  if ((best.manipulator == NULL) ||
+		      (pickResults[k].t < best.t))
+		    {
+		      if (best.manipulator == NULL)
+			numHits++;
+		      best = pickResults[k];
+		    }
+		}
+	    }
+	}
+    }
+  return numHits;
+}
+
+bool
+ManipManager::getManipsInScreenRect(int windowID,
+				    int x0, int y0,
+				    int x1, int y1,
+				    vector<Manip *> &results)
+{
+  flushPendingManips();
+  WindowToManipListTable::iterator windowTableIter =
+    windowManipTable.find(windowID);
+  if (windowTableIter == windowManipTable.end())
+    {
+      cerr << "gleem::ManipManager::getManipsInScreenRect: ERROR: "
+	   << "I got called with a window I had never heard of ("
+	   << windowID << ")." << endl;
+      return false;
+    }
+  ManipList &manips = *windowTableIter;
+  WindowToCameraInfoTable::iterator camIter =
+    windowCameraTable.find(windowID);
+  assert(camIter != windowCameraTable.end());
+  CameraInfo &camInfo = *camIter;
+  int xMin = GLEEM_MIN2(x0, x1);
+  int xMax = GLEEM_MAX2(x0, x1);
+  int yMin = GLEEM_MIN2(y0, y1);
+  int yMax = GLEEM_MAX2(y0, y1);
+  // Give a click (zero-area rectangle) a one-pixel footprint
+  if (xMax == xMin)
+    xMax++;
+  if (yMax == yMin)
+    yMax++;
+  int cornerX[4] = { xMin, xMax, xMax, xMin };
+  int cornerY[4] = { yMin, yMin, yMax, yMax };
+  GleemV3f rayStarts[4];
+  GleemV3f rayDirections[4];
+  for (int i = 0; i < 4; i++)
+    {
+      if (computeRay(camInfo, cornerX[i], cornerY[i],
+		     rayStarts[i], rayDirections[i]) == false)
+	{
+	  cerr << "gleem::ManipManager::getManipsInScreenRect: ERROR: "
+	       << "camera parameters or screen to ray mapping were "
+	       << "unspecified" << endl;
+	  return false;
+	}
+    }
+  Frustum worldFrustum;
+  worldFrustum.setFromCornerRays(rayStarts, rayDirections);
+  updateScreenScales(camInfo, manips);
+  Frustum scaledFrustum;
+  BSphere bsph;
+  for (int j = 0; j < manips.size(); j++)
+    {
+      Manip *manip = manips[j];
+      // Test manipulators kept at a screen size in their own unscaled
+      // space
+      const Frustum *frustumPtr = &worldFrustum;
+      float scale = getScreenScale(camInfo, j);
+      if (scale != 1)
+	{
+	  worldFrustum.getScaledAbout(camInfo.screenScaleCenters[j], scale,
+				      scaledFrustum);
+	  frustumPtr = &scaledFrustum;
+	}
+      const Frustum &frustum = *frustumPtr;
+      ManipPartTable *table = manip->getActivePartTable();
+      if (table != NULL)
+	{
+	  if ((!manip->getBoundingSphere(bsph) ||
+	       frustum.intersectsSphere(bsph)) &&
+	      table->intersectFrustum(frustum))
+	    results.push_back(manip);
+	}
+      else if (manip->intersectFrustum(frustum))
+	results.push_back(manip);
+    }
+  return true;
+}
+
+bool
+ManipManager::mapPixelToRay(int windowID, int x, int y,
+			    GleemV3f &raySource,
+			    GleemV3f &rayDirection)
+{
+  flushPendingManips();
+  WindowToCameraInfoTable::iterator iter =
+    windowCameraTable.find(windowID);
+  if (iter == windowCameraTable.end())
+    return false;
+  return computeRay(*iter, x, y, raySource, rayDirection);
+}
+
+bool
+ManipManager::mapPixelsToRays(int windowID,
+			      int x, int y,
+			      int width, int height,
+			      GleemV3f *raySources,
+			      GleemV3f *rayDirections)
+{
+  flushPendingManips();
+  WindowToCameraInfoTable::iterator iter =
+    windowCameraTable.find(windowID);
+  if ((iter == windowCameraTable.end()) || !(*iter).basisValid)
+    return false;
+  int idx = 0;
+  if (!(*iter).affine)
+    {
+      for (int j = 0; j < height; j++)
+	for (int i = 0; i < width; i++, idx++)
+	  computeRay(*iter, x + i, y + j, raySources[idx],
+		     rayDirections[idx]);
+      return true;
+    }
+  const ScreenToRayBasis &basis = (*iter).pixelBasis;
+  GleemV3f rowSource, rowDirection;
+  for (int j = 0; j < height; j++)
+    {
+      basis.mapScreenToRay(GleemV2f((float) x, (float) (y + j)),
+			   rowSource, rowDirection);
+      for (int i = 0; i < width; i++, idx++)
+	{
+	  GleemV3f::addScaled(rowSource, (float) i, basis.originDu,
+			      raySources[idx]);
+	  GleemV3f::addScaled(rowDirection, (float) i, basis.directionDu,
+			      rayDirections[idx]);
+	}
+    }
+  return true;
+}
+
+bool
+ManipManager::getStats(int windowID, ManipStats &lastFrame, ManipStats &total)
+{
+  flushPendingManips();
+#ifdef GLEEM_ENABLE_STATS
+  WindowToStatsTable::iterator iter = windowStatsTable.find(windowID);
+  if (iter == windowStatsTable.end())
+    return false;
+  lastFrame = (*iter).lastFrame;
+  total = (*iter).total;
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool
+ManipManager::getLatencyHistogram(int windowID, LatencyHistogram &hist)
+{
+  flushPendingManips();
+#ifdef GLEEM_ENABLE_STATS
+  WindowToStatsTable::iterator iter = windowStatsTable.find(windowID);
+  if (iter == windowStatsTable.end())
+    return false;
+  hist = (*iter).latency;
+  return true;
+#else
+  return false;
+#endif
+}
+
+void
+ManipManager::resetStats()
+{
+#ifdef GLEEM_ENABLE_STATS
+  for (WindowToStatsTable::iterator iter = windowStatsTable.begin();
+       iter != windowStatsTable.end();
+       iter++)
+    {
+      (*iter).frame.reset();
+      (*iter).lastFrame.reset();
+      (*iter).total.reset();
+      (*iter).latency.reset();
+      (*iter).pendingEvents.erase((*iter).pendingEvents.begin(),
+				  (*iter).pendingEvents.end());
+    }
+#endif
+}
+
+void
+ManipManager::setDefaultWindow(int windowID)
+{
+  defaultWindow = windowID;
+}
+
+int
+ManipManager::getDefaultWindow() const
+{
+  return defaultWindow;
+}
+
+void
+ManipManager::setPartArenasEnabled(bool enabled)
+{
+  partArenasEnabled = enabled;
+}
+
+bool
+ManipManager::getPartArenasEnabled() const
+{
+  return partArenasEnabled;
+}
+
+void
+ManipManager::setPartTablesEnabled(bool enabled)
+{
+  partTablesEnabled = enabled;
+}
+
+bool
+ManipManager::getPartTablesEnabled() const
+{
+  return partTablesEnabled;
+}
+
+void
+ManipManager::setFrustumCullingEnabled(bool enabled)
+{
+  frustumCullingEnabled = enabled;
+}
+
+bool
+ManipManager::getFrustumCullingEnabled() const
+{
+  return frustumCullingEnabled;
+}
+
+void
+ManipManager::setDetailThresholds(float boxPixels, float pointPixels)
+{
+  detailBoxPixels = boxPixels;
+  detailPointPixels = pointPixels;
+}
+
+void
+ManipManager::getDetailThresholds(float &boxPixels, float &pointPixels) const
+{
+  boxPixels = detailBoxPixels;
+  pointPixels = detailPointPixels;
+}
+
+void
+ManipManager::flushPendingManips()
+{
+  if (pendingManips == NULL)
+    return;
+  PendingManip *list;
+  do
+    {
+      list = pendingManips;
+    }
+  while (Atomic::compareAndSwapPtr((void * volatile *) &pendingManips,
+				   list, NULL) == false);
+  // Reverse into creation order
+  PendingManip *ordered = NULL;
+  while (list != NULL)
+    {
+      PendingManip *next = list->next;
+      list->next = ordered;
+      ordered = list;
+      list = next;
+    }
+  while (ordered != NULL)
+    {
+      PendingManip *next = ordered->next;
+      attachManip(ordered->manip, ordered->windowID);
+      delete ordered;
+      ordered = next;
+    }
+}
+
+void
+ManipManager::queueManipForWindow(Manip *manip, int windowID)
+{
+  PendingManip *entry = new PendingManip;
+  entry->manip = manip;
+  entry->windowID = windowID;
+  do
+    {
+      entry->next = pendingManips;
+    }
+  while (Atomic::compareAndSwapPtr((void * volatile *) &pendingManips,
+				   entry->next, entry) == false);
+}
+
 void
 ManipManager::installGLUTCallbacks(int windowID)
 {
@@ -175,7 +776,8 @@ ManipManager::installGLUTCallbacks(int windowID)
 void
 ManipManager::mouseFunc(int button, int state, int x, int y)
 {
-  getManipManager()->mouseMethod(glutGetWindow(), button, state, x, y);
+  getManipManager()->mouseMethod(glutGetWindow(), button, state, x, y,
+				 glutGetModifiers());
 }
 
 void
@@ -190,6 +792,26 @@ ManipManager::passiveMotionFunc(int x, int y)
   getManipManager()->passiveMotionMethod(glutGetWindow(), x, y);
 }
 
+int
+ManipManager::getModifiers() const
+{
+  return modifiers;
+}
+
+int
+ManipManager::getWindowForNewManip() const
+{
+  if (defaultWindow != 0)
+    return defaultWindow;
+  return glutGetWindow();
+}
+
+bool
+ManipManager::isOwningThread() const
+{
+  return (Thread::getCurrentID() == owningThread);
+}
+
 ScreenToRayMapping *
 ManipManager::getScreenToRayMapping()
 {
@@ -200,43 +822,247 @@ void
 ManipManager::setScreenToRayMapping(ScreenToRayMapping *map)
 {
   mapping = map;
+  for (WindowToCameraInfoTable::iterator iter = windowCameraTable.begin();
+       iter != windowCameraTable.end();
+       iter++)
+    recomputeBasis(*iter);
+}
+
+bool
+ManipManager::setScreenToRayMapping(int windowID, ScreenToRayMapping *map)
+{
+  flushPendingManips();
+  WindowToCameraInfoTable::iterator iter =
+    windowCameraTable.find(windowID);
+  if (iter == windowCameraTable.end())
+    {
+      cerr << "gleem::ManipManager::setScreenToRayMapping: ERROR: "
+	   << "I got called with a window I had never heard of ("
+	   << windowID << ")." << endl;
+      return false;
+    }
+  (*iter).mapping = map;
+  recomputeBasis(*iter);
+  return true;
+}
+
+ScreenToRayMapping *
+ManipManager::getScreenToRayMapping(int windowID)
+{
+  flushPendingManips();
+  WindowToCameraInfoTable::iterator iter =
+    windowCameraTable.find(windowID);
+  if (iter == windowCameraTable.end())
+    return NULL;
+  if ((*iter).mapping != NULL)
+    return (*iter).mapping;
+  return mapping;
 }
 
 void
 ManipManager::removeManip(Manip *manip)
 {
+  // The manip may still be in the queue
+  flushPendingManips();
   if (curManip == manip)
     {
       cerr << "ManipManager::removeManip: WARNING: it's a bad idea to delete "
 	   << "a manipulator while you're dragging it" << endl;
       curManip = NULL;
     }
+  if (curHighlightedManip == manip)
+    curHighlightedManip = NULL;
+  ManipList::iterator iter = find(frameCallbackManips.begin(),
+				  frameCallbackManips.end(), manip);
+  if (iter != frameCallbackManips.end())
+    frameCallbackManips.erase(iter);
   removeEntryForManip(manip);
 }
 
+void
+ManipManager::queueFrameCallbacks(Manip *manip)
+{
+  frameCallbackManips.push_back(manip);
+}
+
+ManipCallbackWorker *
+ManipManager::getCallbackWorker()
+{
+  if (callbackWorker == NULL)
+    callbackWorker = new ManipCallbackWorker();
+  return callbackWorker;
+}
+
+void
+ManipManager::setTargetThreads(int numThreads)
+{
+  delete targetPool;
+  targetPool = NULL;
+  if (numThreads > 0)
+    targetPool = new TaskPool(numThreads);
+}
+
+int
+ManipManager::getTargetThreads() const
+{
+  return (targetPool != NULL) ? targetPool->getNumThreads() : 0;
+}
+
+TaskPool *
+ManipManager::getTargetPool()
+{
+  return targetPool;
+}
+
+void
+ManipManager::invalidateScreenScales()
+{
+  Atomic::fetchAndAdd(&screenScalesGeneration, 1);
+}
+
+void
+ManipManager::waitForWorkerCallbacks()
+{
+  if (callbackWorker != NULL)
+    callbackWorker->waitUntilIdle();
+}
+
+void
+ManipManager::dispatchFrameCallbacks()
+{
+  // Callbacks may delete manipulators, which removes them from the
+  // list, so take them off one at a time. Those queued again by the
+  // callbacks wait for the next frame.
+  int numManips = frameCallbackManips.size();
+  for (int i = 0; (i < numManips) && (frameCallbackManips.size() > 0); i++)
+    {
+      Manip *manip = frameCallbackManips[0];
+      frameCallbackManips.erase(frameCallbackManips.begin());
+      manip->dispatchFrameCallbacks();
+    }
+}
+
+bool
+ManipManager::startRecording(const char *fileName)
+{
+  return eventLog.openForWriting(fileName);
+}
+
+void
+ManipManager::stopRecording()
+{
+  eventLog.close();
+}
+
+bool
+ManipManager::isRecording() const
+{
+  return eventLog.isWriting();
+}
+
+int
+ManipManager::replayEvents(const char *fileName)
+{
+  EventLog log;
+  if (log.openForReading(fileName) == false)
+    return -1;
+  int numEvents = 0;
+  EventLog::Event event;
+  while (log.read(event))
+    {
+      replayEvent(event);
+      ++numEvents;
+    }
+  return numEvents;
+}
+
+void
+ManipManager::replayEvent(const EventLog::Event &event)
+{
+  bool wasReplaying = replaying;
+  replaying = true;
+  switch (event.type)
+    {
+    case EventLog::MOUSE:
+      mouseMethod(event.windowID, event.button, event.state,
+		  event.x, event.y, event.modifiers);
+      break;
+    case EventLog::MOTION:
+      motionMethod(event.windowID, event.x, event.y);
+      break;
+    case EventLog::PASSIVE_MOTION:
+      passiveMotionMethod(event.windowID, event.x, event.y);
+      break;
+    case EventLog::CAMERA:
+      updateCameraParameters(event.windowID, event.params);
+      break;
+    }
+  replaying = wasReplaying;
+}
+
+void
+ManipManager::recordEvent(const EventLog::Event &event)
+{
+  if (!replaying)
+    eventLog.write(event);
+}
+
 const CameraParameters &
 ManipManager::getCameraParameters(int windowID)
 {
-  WindowToCameraParametersTable::iterator iter =
+  flushPendingManips();
+  WindowToCameraInfoTable::iterator iter =
     windowCameraTable.find(windowID);
   assert(iter != windowCameraTable.end());
-  return *iter;
+  return (*iter).params;
 }
 
 ManipManager::ManipManager() :
   windowManipTable(MANIP_MANAGER_NUM_WINDOWS, hash<int>()),
   manipWindowTable(MANIP_MANAGER_NUM_MANIPS, &ManipManager::hashManip),
   windowCameraTable(MANIP_MANAGER_NUM_WINDOWS, hash<int>())
+#ifdef GLEEM_ENABLE_STATS
+  , windowStatsTable(MANIP_MANAGER_NUM_WINDOWS, hash<int>())
+#endif
 {
   mapping = new RightTruncPyrMapping();
+  owningThread = Thread::getCurrentID();
+  replaying = false;
+  pendingManips = NULL;
+  defaultWindow = 0;
+  partArenasEnabled = true;
+  partTablesEnabled = true;
+  frustumCullingEnabled = true;
+  detailBoxPixels = 24;
+  detailPointPixels = 6;
+  screenScalesGeneration = 0;
+  modifiers = 0;
   dragging = false;
   curManip = NULL;
   curHighlightedManip = NULL;
+  callbackWorker = NULL;
+  targetPool = NULL;
 }
 
 void
-ManipManager::mouseMethod(int windowID, int button, int state, int x, int y)
+ManipManager::mouseMethod(int windowID, int button, int state, int x, int y,
+			  int modifiers)
 {
+  GLEEM_STATS_START_EVENT(windowID);
+  flushPendingManips();
+  if (eventLog.isWriting())
+    {
+      EventLog::Event event;
+      event.type = EventLog::MOUSE;
+      event.windowID = windowID;
+      event.button = button;
+      event.state = state;
+      event.modifiers = modifiers;
+      event.x = x;
+      event.y = y;
+      recordEvent(event);
+    }
+  this->modifiers = modifiers;
   WindowToManipListTable::iterator windowTableIter =
     windowManipTable.find(windowID);
   if (windowTableIter == windowManipTable.end())
@@ -249,45 +1075,33 @@ ManipManager::mouseMethod(int windowID, int button, int state, int x, int y)
       return;
     }
   ManipList &manips = *windowTableIter;
-  const CameraParameters &params = getCameraParameters(windowID);
+  GLEEM_STATS_WINDOW_SCOPE(windowID);
+  WindowToCameraInfoTable::iterator camIter =
+    windowCameraTable.find(windowID);
+  assert(camIter != windowCameraTable.end());
+  CameraInfo &camInfo = *camIter;
   if (button == GLUT_LEFT_BUTTON)
     {
       if (state == GLUT_DOWN)
 	{
 	  // Compute ray in 3D
 	  GleemV3f raySource, rayDirection;
-	  if (computeRay(params, x, y, raySource, rayDirection) == false)
+	  if (computeRay(camInfo, x, y, raySource, rayDirection) == false)
 	    {
 	      cerr << "gleem::ManipManager::mouseFunc: ERROR: "
-		   << "screen to ray mapping was unspecified" << endl;
+		   << "camera parameters or screen to ray mapping were "
+		   << "unspecified" << endl;
 	      return;
 	    }
-	
-	  vector<HitPoint> results;
-	  // Determine hits
-	  int i;
-	  for (i = 0; i < manips.size(); i++)
-	    manips[i]->intersectRay(raySource, rayDirection, results);
-	  // Now find closest one
-	  int closestIdx = -1;
-	  float closest = 0.0f;
-	  for (i = 0; i < results.size(); i++)
-	    {
-	      if ((closestIdx == -1) ||
-		  (results[i].t < closest))
-		{
-		  closestIdx = i;
-		  closest = results[i].t;
-		}
-	    }
-	  if (closestIdx != -1)
+
+	  HitPoint hp;
+	  if (pickClosest(manips, camInfo, raySource, rayDirection, hp))
 	    {
 	      if (curHighlightedManip != NULL)
 		{
 		  curHighlightedManip->clearHighlight();
 		  curHighlightedManip = NULL;
 		}
-	      const HitPoint &hp = results[closestIdx];
 	      assert(hp.manipulator != NULL);
 	      hp.manipulator->makeActive(hp);
 	      curManip = hp.manipulator;
@@ -303,7 +1117,7 @@ ManipManager::mouseMethod(int windowID, int button, int state, int x, int y)
 	      dragging = false;
 	      curManip = NULL;
 	      // Check to see where mouse is
-	      passiveMotionMethod(windowID, x, y);
+	      updateHighlight(windowID, x, y);
 	    }
 	}
     }
@@ -312,6 +1126,17 @@ ManipManager::mouseMethod(int windowID, int button, int state, int x, int y)
 void
 ManipManager::motionMethod(int windowID, int x, int y)
 {
+  GLEEM_STATS_START_EVENT(windowID);
+  flushPendingManips();
+  if (eventLog.isWriting())
+    {
+      EventLog::Event event;
+      event.type = EventLog::MOTION;
+      event.windowID = windowID;
+      event.x = x;
+      event.y = y;
+      recordEvent(event);
+    }
   WindowToManipListTable::iterator windowTableIter =
     windowManipTable.find(windowID);
   if (windowTableIter == windowManipTable.end())
@@ -324,16 +1149,21 @@ ManipManager::motionMethod(int windowID, int x, int y)
       return;
     }
   ManipList &manips = *windowTableIter;
-  const CameraParameters &params = getCameraParameters(windowID);
+  GLEEM_STATS_WINDOW_SCOPE(windowID);
+  WindowToCameraInfoTable::iterator camIter =
+    windowCameraTable.find(windowID);
+  assert(camIter != windowCameraTable.end());
+  const CameraInfo &camInfo = *camIter;
   //  cerr << "motionFunc" << endl;
   if (dragging)
     {
       // Compute ray in 3D
       GleemV3f raySource, rayDirection;
-      if (computeRay(params, x, y, raySource, rayDirection) == false)
+      if (computeRay(camInfo, x, y, raySource, rayDirection) == false)
 	{
 	  cerr << "gleem::ManipManager::motionFunc: ERROR: "
-	       << "screen to ray mapping was unspecified" << endl;
+	       << "camera parameters or screen to ray mapping were "
+	       << "unspecified" << endl;
 	  return;
 	}
       if (curManip == NULL)
@@ -344,12 +1174,30 @@ ManipManager::motionMethod(int windowID, int x, int y)
 	  dragging = false;
 	  return;
 	}
+      GLEEM_STATS_TIMER(dragNanos);
+      GLEEM_TRACE_SCOPE("Manip::drag", curManip);
       curManip->drag(raySource, rayDirection);
     }
 }
 
 void
 ManipManager::passiveMotionMethod(int windowID, int x, int y)
+{
+  flushPendingManips();
+  if (eventLog.isWriting())
+    {
+      EventLog::Event event;
+      event.type = EventLog::PASSIVE_MOTION;
+      event.windowID = windowID;
+      event.x = x;
+      event.y = y;
+      recordEvent(event);
+    }
+  updateHighlight(windowID, x, y);
+}
+
+void
+ManipManager::updateHighlight(int windowID, int x, int y)
 {
   // FIXME: workaround for minor GLUT bug where passiveMotionFunc is
   // called upon window entry/exit
@@ -368,49 +1216,134 @@ ManipManager::passiveMotionMethod(int windowID, int x, int y)
       return;
     }
   ManipList &manips = *windowTableIter;
-  const CameraParameters &params = getCameraParameters(windowID);
+  GLEEM_STATS_WINDOW_SCOPE(windowID);
+  WindowToCameraInfoTable::iterator camIter =
+    windowCameraTable.find(windowID);
+  assert(camIter != windowCameraTable.end());
+  CameraInfo &camInfo = *camIter;
   //  cerr << "passiveMotionFunc" << endl;
   // Compute ray in 3D
   GleemV3f raySource, rayDirection;
-  if (computeRay(params, x, y, raySource, rayDirection) == false)
+  if (computeRay(camInfo, x, y, raySource, rayDirection) == false)
     {
       cerr << "gleem::ManipManager::passiveMotionFunc: ERROR: "
-	   << "screen to ray mapping was unspecified" << endl;
+	   << "camera parameters or screen to ray mapping were "
+	   << "unspecified" << endl;
       return;
     }
 
-  vector<HitPoint> results;
-  // Determine hits
+  HitPoint hp;
+  bool gotHit = pickClosest(manips, camInfo, raySource, rayDirection, hp);
+  if (curHighlightedManip != NULL)
+    {
+      curHighlightedManip->clearHighlight();
+    }
+  if (gotHit)
+    {
+      assert(hp.manipulator != NULL);
+      assert(hp.manipPart != NULL);
+      curHighlightedManip = hp.manipulator;
+      curHighlightedManip->highlight(hp);
+      //      cerr << "Highlighted manip" << endl;
+    }
+  else
+    curHighlightedManip = NULL;
+}
+
+bool
+ManipManager::pickClosest(ManipList &manips,
+			  CameraInfo &info,
+			  const GleemV3f &rayStart,
+			  const GleemV3f &rayDirection,
+			  HitPoint &closestHit)
+{
+  GLEEM_STATS_TIMER(pickNanos);
+  GLEEM_STATS_INC(raysCast);
+  updateScreenScales(info, manips);
+  // Determine hits, skipping manipulators whose bounds the ray misses
+  pickResults.erase(pickResults.begin(), pickResults.end());
+  BSphere bsph;
   int i;
   for (i = 0; i < manips.size(); i++)
-    manips[i]->intersectRay(raySource, rayDirection, results);
+    {
+      GLEEM_STATS_INC(manipsVisited);
+      Manip *manip = manips[i];
+      bool haveBounds = manip->getBoundingSphere(bsph);
+      if (haveBounds)
+	scaleBounds(info, i, bsph);
+      if (haveBounds && !bsph.hitByRay(rayStart, rayDirection))
+	{
+	  GLEEM_STATS_INC(boundRejects);
+	  continue;
+	}
+      updateDetailLevel(info, manip, haveBounds, bsph);
+      intersectManip(info, i, manip, rayStart, rayDirection, pickResults);
+    }
+  GLEEM_STATS_ADD(hitsProduced, pickResults.size());
   // Now find closest one
   int closestIdx = -1;
   float closest = 0.0f;
-  for (i = 0; i < results.size(); i++)
+  for (i = 0; i < pickResults.size(); i++)
     {
       if ((closestIdx == -1) ||
-	  (results[i].t < closest))
+	  (pickResults[i].t < closest))
 	{
 	  closestIdx = i;
-	  closest = results[i].t;
+	  closest = pickResults[i].t;
 	}
     }
-  if (curHighlightedManip != NULL)
+  if (closestIdx == -1)
+    return false;
+  closestHit = pickResults[closestIdx];
+  return true;
+}
+
+void
+ManipManager::intersectManip(const CameraInfo &info, int index, Manip *manip,
+			     const GleemV3f &rayStart,
+			     const GleemV3f &rayDirection,
+			     vector<HitPoint> &results)
+{
+  Manip::DetailLevel level = manip->getDetailLevel();
+  if (level == Manip::POINT_DETAIL)
+    return;
+  GLEEM_TRACE_SCOPE("Manip::intersectRay", manip);
+  ManipPartTable *table = NULL;
+  if (level == Manip::FULL_DETAIL)
+    table = manip->getActivePartTable();
+  float scale = getScreenScale(info, index);
+  if (scale == 1)
     {
-      curHighlightedManip->clearHighlight();
+      if (table != NULL)
+	table->intersectRay(rayStart, rayDirection, results);
+      else
+	manip->intersectRay(rayStart, rayDirection, results);
+      return;
     }
-  if (closestIdx != -1)
+  // Cast the ray into the manipulator's unscaled geometry instead.
+  // Points along both rays correspond at the same t, so the hits'
+  // parameters can be compared with those of other manipulators.
+  const GleemV3f &center = info.screenScaleCenters[index];
+  float invScale = 1.0f / scale;
+  GleemV3f localStart;
+  GleemV3f::sub(rayStart, center, localStart);
+  GleemV3f::addScaled(center, invScale, localStart, localStart);
+  GleemV3f localDirection;
+  GleemV3f::scale(rayDirection, invScale, localDirection);
+  int firstHit = results.size();
+  if (table != NULL)
+    table->intersectRay(localStart, localDirection, results);
+  else
+    manip->intersectRay(localStart, localDirection, results);
+  for (int i = firstHit; i < results.size(); i++)
     {
-      const HitPoint &hp = results[closestIdx];
-      assert(hp.manipulator != NULL);
-      assert(hp.manipPart != NULL);
-      curHighlightedManip = hp.manipulator;
-      curHighlightedManip->highlight(hp);
-      //      cerr << "Highlighted manip" << endl;
+      HitPoint &hit = results[i];
+      hit.rayStart = rayStart;
+      hit.rayDirection = rayDirection;
+      GleemV3f offset;
+      GleemV3f::sub(hit.intPt, center, offset);
+      GleemV3f::addScaled(center, scale, offset, hit.intPt);
     }
-  else
-    curHighlightedManip = NULL;
 }
 
 void
@@ -445,6 +1378,7 @@ ManipManager::removeEntryForManip(Manip *manip)
       manipList.erase(manipListIter);
     }
   manipWindowTable.erase(iter);
+  invalidateScreenScales();
 }
 
 bool
@@ -465,9 +1399,22 @@ ManipManager::createEntryForWindow(int windowID)
       pair<WindowToManipListTable::iterator, bool> result =
 	windowManipTable.insert_unique(windowID, ManipList());
       assert(result.second == true);
-      pair<WindowToCameraParametersTable::iterator, bool> result2 =
-	windowCameraTable.insert_unique(windowID, CameraParameters());
+      CameraInfo info;
+      info.mapping = NULL;
+      info.paramsValid = false;
+      info.basisValid = false;
+      info.mappingGeneration = 0;
+      info.affine = false;
+      info.screenScalesValid = false;
+      info.screenScalesGeneration = 0;
+      pair<WindowToCameraInfoTable::iterator, bool> result2 =
+	windowCameraTable.insert_unique(windowID, info);
       assert(result2.second == true);
+#ifdef GLEEM_ENABLE_STATS
+      pair<WindowToStatsTable::iterator, bool> result3 =
+	windowStatsTable.insert_unique(windowID, WindowStats());
+      assert(result3.second == true);
+#endif
     }
 }
 
@@ -478,10 +1425,16 @@ ManipManager::removeEntryForWindow(int windowID)
     windowManipTable.find(windowID);
   if (iter == windowManipTable.end())
     return;
-  WindowToCameraParametersTable::iterator camIter =
+  WindowToCameraInfoTable::iterator camIter =
     windowCameraTable.find(windowID);
   assert(camIter != windowCameraTable.end());
   windowCameraTable.erase(camIter);
+#ifdef GLEEM_ENABLE_STATS
+  WindowToStatsTable::iterator statsIter = windowStatsTable.find(windowID);
+  assert(statsIter != windowStatsTable.end());
+  assert(ManipStats::current != &(*statsIter).frame);
+  windowStatsTable.erase(statsIter);
+#endif
   ManipList &manips = *iter;
   for (int i = 0; i < manips.size(); i++)
     {
@@ -508,31 +1461,246 @@ ManipManager::findEntryForWindow(int windowID)
   return true;
 }
 
-GleemV2f
-ManipManager::screenToNormalizedCoordinates(const CameraParameters &params,
-					    int x, int y)
+#ifdef GLEEM_ENABLE_STATS
+ManipStats *
+ManipManager::getFrameStats(int windowID)
 {
-  GleemV2f retval;
+  WindowToStatsTable::iterator iter = windowStatsTable.find(windowID);
+  if (iter == windowStatsTable.end())
+    return NULL;
+  return &(*iter).frame;
+}
 
-  // GLUT's origin is upper left
-  retval[0] = (float) x / (float) (params.xSize - 1);
-  retval[1] = (float) y / (float) (params.ySize - 1);
-  retval[0] = (retval[0] - 0.5f) * 2.0f;
-  retval[1] = (0.5f - retval[1]) * 2.0f;
-  return retval;
+void
+ManipManager::startStatsEvent(int windowID, GleemInt64 arrivalTime)
+{
+  WindowToStatsTable::iterator iter = windowStatsTable.find(windowID);
+  if (iter == windowStatsTable.end())
+    return;
+  WindowStats &stats = *iter;
+  // If the application isn't rendering, keep only the oldest (and
+  // therefore slowest) events
+  if (stats.pendingEvents.size() < MANIP_MANAGER_MAX_PENDING_EVENTS)
+    stats.pendingEvents.push_back(arrivalTime);
+}
+
+void
+ManipManager::endStatsFrame(int windowID)
+{
+  WindowToStatsTable::iterator iter = windowStatsTable.find(windowID);
+  if (iter == windowStatsTable.end())
+    return;
+  WindowStats &stats = *iter;
+  stats.total.add(stats.frame);
+  stats.lastFrame = stats.frame;
+  stats.frame.reset();
+  if (stats.pendingEvents.size() > 0)
+    {
+      GleemInt64 now = Clock::nanoTime();
+      for (int i = 0; i < stats.pendingEvents.size(); i++)
+	stats.latency.record(now - stats.pendingEvents[i]);
+      stats.pendingEvents.erase(stats.pendingEvents.begin(),
+				stats.pendingEvents.end());
+    }
+}
+#endif
+
+void
+ManipManager::recomputeBasis(CameraInfo &info)
+{
+  ScreenToRayMapping *map = info.mapping;
+  if (map == NULL)
+    map = mapping;
+  info.basisValid = ((map != NULL) && info.paramsValid);
+  info.screenScalesValid = false;
+  if (!info.basisValid)
+    return;
+  info.mappingGeneration = map->getGeneration();
+  info.affine = map->isAffine();
+  map->computeBasis(info.params, info.basis);
+  info.basis.makePixelBasis(info.params.xSize, info.params.ySize,
+			    info.pixelBasis);
+  // The rays through the window's corners bound what it can show
+  float cornerX[4] = { 0, (float) info.params.xSize,
+		       (float) info.params.xSize, 0 };
+  float cornerY[4] = { 0, 0, (float) info.params.ySize,
+		       (float) info.params.ySize };
+  GleemV3f rayStarts[4];
+  GleemV3f rayDirections[4];
+  for (int i = 0; i < 4; i++)
+    info.pixelBasis.mapScreenToRay(GleemV2f(cornerX[i], cornerY[i]),
+				   rayStarts[i], rayDirections[i]);
+  info.viewFrustum.setFromCornerRays(rayStarts, rayDirections);
+  // A pixel's extent grows with distance along perspective rays and
+  // is constant along parallel ones
+  GleemV3f dir;
+  info.pixelBasis.mapScreenToRay(GleemV2f(0.5f * (float) info.params.xSize,
+					  0.5f * (float) info.params.ySize),
+				 info.viewOrigin, dir);
+  float dirLen = dir.length();
+  info.viewAxis = dir;
+  info.viewAxis.normalize();
+  info.unitsPerPixel = info.pixelBasis.originDv.length();
+  info.unitsPerPixelPerDepth = (dirLen > 0) ?
+    (info.pixelBasis.directionDv.length() / dirLen) : 0;
+}
+
+void
+ManipManager::updateDetailLevel(const CameraInfo &info, Manip *manip,
+				bool haveBounds, const BSphere &bsph)
+{
+  Manip::DetailLevel coarsest = manip->getCoarsestDetailLevel();
+  if ((coarsest == Manip::FULL_DETAIL) || !haveBounds || !info.basisValid)
+    {
+      manip->setDetailLevel(Manip::FULL_DETAIL);
+      return;
+    }
+  // Spheres reaching behind the eye are treated as large
+  float depth = info.viewAxis.dot(bsph.getCenter() - info.viewOrigin) -
+    bsph.getRadius();
+  float unitsPerPixel = info.unitsPerPixel;
+  if (depth > 0)
+    unitsPerPixel += depth * info.unitsPerPixelPerDepth;
+  Manip::DetailLevel level = Manip::FULL_DETAIL;
+  if (unitsPerPixel > 0)
+    {
+      float pixels = 2.0f * bsph.getRadius() / unitsPerPixel;
+      if (pixels < detailPointPixels)
+	level = Manip::POINT_DETAIL;
+      else if (pixels < detailBoxPixels)
+	level = Manip::BOX_DETAIL;
+    }
+  if (level > coarsest)
+    level = coarsest;
+  manip->setDetailLevel(level);
+}
+
+void
+ManipManager::updateScreenScales(CameraInfo &info, const ManipList &manips)
+{
+  // Read once; a change made after this is caught by the next call
+  long generation = Atomic::load(&screenScalesGeneration);
+  if (info.screenScalesValid && (info.screenScalesGeneration == generation))
+    return;
+  info.screenScalesValid = true;
+  info.screenScalesGeneration = generation;
+  info.screenScales.erase(info.screenScales.begin(), info.screenScales.end());
+  info.screenScaleCenters.erase(info.screenScaleCenters.begin(),
+				info.screenScaleCenters.end());
+  int num = manips.size();
+  int i;
+  bool any = false;
+  for (i = 0; (i < num) && !any; i++)
+    if (manips[i]->getScreenSize() > 0)
+      any = true;
+  if (!any || !info.basisValid)
+    return;
+
+  // Gather the centers, radii and sizes, then compute all of the
+  // scale factors in one loop over the arrays. A manipulator without
+  // a screen size or bounds gets a size of 0, and so a factor of 1.
+  screenScaleScratch.resize(5 * num);
+  float *xs = &screenScaleScratch[0];
+  float *ys = xs + num;
+  float *zs = ys + num;
+  float *radii = zs + num;
+  float *pixels = radii + num;
+  info.screenScaleCenters.resize(num);
+  ManipState state;
+  BSphere bsph;
+  for (i = 0; i < num; i++)
+    {
+      Manip *manip = manips[i];
+      manip->getState(state);
+      info.screenScaleCenters[i] = state.translation;
+      xs[i] = state.translation[0];
+      ys[i] = state.translation[1];
+      zs[i] = state.translation[2];
+      pixels[i] = manip->getScreenSize();
+      radii[i] = 1;
+      if ((pixels[i] > 0) && manip->getBoundingSphere(bsph) &&
+	  (bsph.getRadius() > 0))
+	radii[i] = bsph.getRadius();
+      else
+	pixels[i] = 0;
+    }
+  info.screenScales.resize(num);
+  float *scales = &info.screenScales[0];
+  float ox = info.viewOrigin[0];
+  float oy = info.viewOrigin[1];
+  float oz = info.viewOrigin[2];
+  float ax = info.viewAxis[0];
+  float ay = info.viewAxis[1];
+  float az = info.viewAxis[2];
+  float unitsPerPixel = info.unitsPerPixel;
+  float unitsPerPixelPerDepth = info.unitsPerPixelPerDepth;
+  for (i = 0; i < num; i++)
+    {
+      float depth = ((xs[i] - ox) * ax + (ys[i] - oy) * ay +
+		     (zs[i] - oz) * az);
+      depth = GLEEM_MAX2(depth, 0.0f);
+      float scale = (0.5f * pixels[i] *
+		     (unitsPerPixel + depth * unitsPerPixelPerDepth) /
+		     radii[i]);
+      scales[i] = (scale > 0) ? scale : 1.0f;
+    }
+}
+
+float
+ManipManager::getScreenScale(const CameraInfo &info, int index) const
+{
+  if (info.screenScales.size() == 0)
+    return 1;
+  return info.screenScales[index];
+}
+
+void
+ManipManager::scaleBounds(const CameraInfo &info, int index,
+			  BSphere &bsph) const
+{
+  float scale = getScreenScale(info, index);
+  if (scale == 1)
+    return;
+  const GleemV3f &center = info.screenScaleCenters[index];
+  GleemV3f offset;
+  GleemV3f::sub(bsph.getCenter(), center, offset);
+  GleemV3f newCenter;
+  GleemV3f::addScaled(center, scale, offset, newCenter);
+  bsph.setValue(newCenter, scale * bsph.getRadius());
 }
 
 bool
-ManipManager::computeRay(const CameraParameters &params,
+ManipManager::computeRay(const CameraInfo &info,
 			 int x, int y,
 			 GleemV3f &raySource,
 			 GleemV3f &rayDirection)
 {
-  if (mapping == NULL)
+  if (!info.basisValid)
     return false;
-  mapping->mapScreenToRay(screenToNormalizedCoordinates(params, x, y),
-			  params,
-			  raySource,
-			  rayDirection);
+  if (info.affine)
+    {
+      info.pixelBasis.mapScreenToRay(GleemV2f((float) x, (float) y),
+				     raySource, rayDirection);
+      return true;
+    }
+  ScreenToRayMapping *map = (info.mapping != NULL) ? info.mapping : mapping;
+  map->mapScreenToRay(screenToNormalizedCoordinates(info.params, x, y),
+		      info.params, raySource, rayDirection);
   return true;
 }
+
+GleemV2f
+ManipManager::screenToNormalizedCoordinates(const CameraParameters &params,
+					    int x, int y)
+{
+  GleemV2f retval;
+
+  // GLUT's origin is upper left
+  int xMax = (params.xSize > 1) ? (params.xSize - 1) : 1;
+  int yMax = (params.ySize > 1) ? (params.ySize - 1) : 1;
+  retval[0] = (float) x / (float) xMax;
+  retval[1] = (float) y / (float) yMax;
+  retval[0] = (retval[0] - 0.5f) * 2.0f;
+  retval[1] = (0.5f - retval[1]) * 2.0f;
+  return retval;
+}
@@ -8,15 +8,24 @@
 #define _GLEEM_MANIPMANAGER_H
 
 #include <vector.h>
+#include <pair.h>
 #include <gleem/Namespace.h>
 #include <gleem/GleemDLL.h>
 #include <gleem/Util.h>
+#include <gleem/EventLog.h>
+#include <gleem/HitPoint.h>
+#include <gleem/ManipStats.h>
+#include <gleem/LatencyHistogram.h>
 #include <gleem/ScreenToRayMapping.h>
+#include <gleem/Frustum.h>
 #include <gleem/BasicHashtable.h>
+#include <gleem/Thread.h>
 
 GLEEM_ENTER_NAMESPACE
 
 class Manip;
+class ManipCallbackWorker;
+class TaskPool;
 
 /** This class is a singleton and keeps track of all instantiated manips */
 
@@ -29,7 +38,19 @@ public:
       callbacks for the current window (i.e., that returned from
       glutGetWindow()). If your application uses these then you can
       pass a value of false to the initialization function and call
-      them manually at the end of your callbacks. */
+      them manually at the end of your callbacks.
+
+      Threads: the ManipManager belongs to the thread which calls
+      init(), normally the one running the GLUT main loop, and except
+      as noted below its methods must only be called from that
+      thread. Manips (and their parts) may also be constructed on
+      other threads, for example by scene loaders. Such a manip does
+      not register itself with the manager, since its constructor
+      has not finished; once it is fully constructed, pass it to
+      queueManipForWindow(), which is lock-free and may be called
+      from any thread. The manager picks it up at the start of its
+      next event, render or pick. After that the manip must only be
+      deleted on the owning thread. */
   static void init(bool installGLUTCallbacks = true);
   static ManipManager *getManipManager();
 
@@ -37,7 +58,9 @@ public:
       window in which you are using manipulators. The window ID is a
       GLUT window ID obtained from, i.e., glutCreateWindow(). You must
       coerce your application's camera parameters into the
-      gleem::CameraParameters data structure. */
+      gleem::CameraParameters data structure. The screen to ray basis
+      used for all subsequent picking in this window is computed
+      here. */
   void updateCameraParameters(int windowID, const CameraParameters &params);
 
   /** This must be called each clock tick, and renders all
@@ -78,6 +101,185 @@ public:
       viewed in this window. */
   bool removeManipFromWindow(Manip *manip, int windowID);
 
+  /** Manipulators are normally created into the current GLUT window
+      (i.e., that returned from glutGetWindow()). Setting a nonzero
+      default window causes subsequently created manipulators to be
+      placed into that window instead, without consulting GLUT. This
+      allows manipulators to be created when there is no current
+      window, for example in programs which run without a display.
+      Passing 0 restores the default behavior. */
+  void setDefaultWindow(int windowID);
+  int getDefaultWindow() const;
+
+  /** By default each of the built-in manipulators allocates its
+      ManipParts from an arena of its own (see ManipPartArena), which
+      keeps them together in memory and makes creating and destroying
+      manipulators cheaper. Disabling this causes subsequently
+      created manipulators to allocate their parts individually on
+      the heap. */
+  void setPartArenasEnabled(bool enabled);
+  bool getPartArenasEnabled() const;
+
+  /** By default manipulators which publish their parts in a
+      ManipPartTable are picked, rendered and transformed by iterating
+      over the table rather than by walking their ManipPart trees.
+      Disabling this always uses the virtual methods. */
+  void setPartTablesEnabled(bool enabled);
+  bool getPartTablesEnabled() const;
+
+  /** By default render() skips manipulators whose bounding spheres
+      (see Manip::getBoundingSphere()) lie entirely outside the view
+      frustum of their window, as given by the window's camera
+      parameters and screen to ray mapping. Manipulators without
+      bounds, and all of those in windows whose camera parameters
+      have not been set, are always drawn. Disable this if any
+      manipulator draws outside the bounds it reports. */
+  void setFrustumCullingEnabled(bool enabled);
+  bool getFrustumCullingEnabled() const;
+
+  /** Manipulators which support it (see
+      Manip::getCoarsestDetailLevel()) are drawn and picked in
+      simplified form when they look small: as a box when their
+      bounding spheres are fewer than boxPixels pixels across, and as
+      a point, which can not be picked, below pointPixels. Sizes are
+      estimated from each window's camera parameters, so manipulators
+      in windows whose camera parameters have not been set are always
+      drawn in full. The defaults are 24 and 6 pixels; 0 disables a
+      level. */
+  void setDetailThresholds(float boxPixels, float pointPixels);
+  void getDetailThresholds(float &boxPixels, float &pointPixels) const;
+
+  /** Number of extra threads which help update the targets bound to
+      a manipulator (see Manip::setTargets()) when there are enough
+      of them to be worth splitting up. The default, 0, updates them
+      on the owning thread alone. The threads are started by this
+      call, which must not be made during a drag. */
+  void setTargetThreads(int numThreads);
+  int getTargetThreads() const;
+
+  /** Manipulators constructed on threads other than the owning
+      one (see init()) are added to windows with this method. It may
+      be called from any thread, and only places the manip on a
+      lock-free queue. */
+  void queueManipForWindow(Manip *manip, int windowID);
+
+  /** Blocks until every motion callback queued for the callback
+      worker thread (see Manip::addWorkerMotionCallback()) has run.
+      Call this before destroying anything such callbacks use. */
+  void waitForWorkerCallbacks();
+
+  /** Adds all manipulators queued since the last call to their
+      windows. This is done automatically by render() and by every
+      method which takes a window ID, so there is normally no need to
+      call it. */
+  void flushPendingManips();
+
+  /** Batch picking for offline tools (marquee selection, snapping
+      previews, automated tests). Casts numRays rays, given as
+      parallel arrays of starting points and directions, against all
+      manipulators in the given window and stores the closest hit for
+      each ray in the corresponding element of results. Rays which
+      hit nothing get a HitPoint whose manipulator and manipPart are
+      NULL. The rays need not be in any particular order; they are
+      sorted internally by direction into small packets which share
+      bounding sphere tests. Does not highlight or activate any
+      manipulator. Returns the number of rays which hit something, or
+      -1 if windowID was unknown. */
+  int pickRays(int windowID,
+	       int numRays,
+	       const GleemV3f *rayStarts,
+	       const GleemV3f *rayDirections,
+	       HitPoint *results);
+
+  /** Marquee selection. Appends to results all manipulators in the
+      given window with pickable geometry inside the volume under the
+      screen rectangle with corners (x0, y0) and (x1, y1), given in
+      GLUT window coordinates in either order. Tests are done against
+      bounding volumes of the manipulators' parts, so manipulators
+      just outside the rectangle may occasionally be included.
+      Returns false if windowID was unknown or there was no screen to
+      ray mapping. */
+  bool getManipsInScreenRect(int windowID,
+			     int x0, int y0,
+			     int x1, int y1,
+			     vector<Manip *> &results);
+
+  /** Support for multiple windows. Set the mapping from screen
+      coordinates to rays for one window, for example an
+      OrthographicMapping for a CAD view or an ObliqueTruncPyrMapping
+      for one tile of a tiled display. Passing NULL reverts the window
+      to the default mapping (see getScreenToRayMapping()). The
+      window's ray basis is recomputed immediately. The caller retains
+      ownership of the mapping's memory and must keep it alive until
+      it is replaced or the window is destroyed. Returns false if
+      windowID was unknown. */
+  bool setScreenToRayMapping(int windowID, ScreenToRayMapping *mapping);
+
+  /** Returns the mapping used by the given window: either the one
+      set for it, or the default mapping. Returns NULL if windowID was
+      unknown. */
+  ScreenToRayMapping *getScreenToRayMapping(int windowID);
+
+  /** Compute the ray through the given pixel (in GLUT window
+      coordinates) of the given window using the basis computed in the
+      last call to updateCameraParameters(). Returns false if the
+      window was unknown or its camera parameters or screen to ray
+      mapping were unspecified. */
+  bool mapPixelToRay(int windowID, int x, int y,
+		     GleemV3f &raySource,
+		     GleemV3f &rayDirection);
+
+  /** Compute rays for a width by height block of pixels with upper
+      left corner (x, y), in GLUT window coordinates, of the given
+      window. The rays are written in row-major order into the
+      parallel output arrays, which must each have room for width *
+      height elements. Returns false under the same conditions as
+      mapPixelToRay(). */
+  bool mapPixelsToRays(int windowID,
+		       int x, int y,
+		       int width, int height,
+		       GleemV3f *raySources,
+		       GleemV3f *rayDirections);
+
+  /** Instrumentation. Copies the counters for the given window's
+      last completed frame (a frame ends each time render() draws the
+      window) and the running totals since the window was created or
+      resetStats() was last called. Returns false, leaving the
+      arguments untouched, if windowID was unknown or gleem was
+      compiled without GLEEM_ENABLE_STATS. */
+  bool getStats(int windowID, ManipStats &lastFrame, ManipStats &total);
+
+  /** Input latency. For every mouse and motion event the time from
+      entry into the event handler (including any drag() and motion
+      callbacks it causes) to the completion of the next render() of
+      that window is recorded in a per-window histogram. This copies
+      the histogram for the given window; print it, or query
+      percentiles, to see the p50/p99/p999 latencies. Returns false,
+      leaving the argument untouched, if windowID was unknown or
+      gleem was compiled without GLEEM_ENABLE_STATS. */
+  bool getLatencyHistogram(int windowID, LatencyHistogram &hist);
+
+  /** Zero the counters and latency histograms of all windows. */
+  void resetStats();
+
+  /** Event recording. While recording, every mouse, motion and
+      passive motion event and every change of a window's camera
+      parameters is appended to the named file (see EventLog).
+      Returns false if the file could not be created. Starting a new
+      recording ends the previous one. */
+  bool startRecording(const char *fileName);
+  void stopRecording();
+  bool isRecording() const;
+
+  /** Feeds the events in the named log back through the event
+      handlers as fast as possible. The windows and manipulators must
+      be set up as they were when the log was recorded; replaying the
+      same log into the same scene leaves the manipulators in
+      bit-identical states. Events are not recorded while they are
+      being replayed. Returns the number of events replayed, or -1 if
+      the log could not be opened. */
+  int replayEvents(const char *fileName);
+
 GLEEM_INTERNAL public:
 
   /** This installs the mouse, motion and passive motion callbacks
@@ -101,18 +303,69 @@ GLEEM_INTERNAL public:
       calling it if you don't need it or it's too expensive */
   static void passiveMotionFunc(int x, int y);
 
+  /** The per-window event handlers called by the functions above.
+      These can be called directly to drive the ManipManager without
+      GLUT, for example from a headless benchmark or a replayed event
+      log. modifiers is a combination of the GLUT_ACTIVE_* flags, as
+      returned by glutGetModifiers(). */
+  void mouseMethod(int windowID, int button, int state, int x, int y,
+		   int modifiers = 0);
+  void motionMethod(int windowID, int x, int y);
+  void passiveMotionMethod(int windowID, int x, int y);
+
+  /** Dispatches a single event read from an EventLog to the
+      appropriate handler above (or to updateCameraParameters()).
+      Used by replayEvents(); available so that players can time
+      individual events. */
+  void replayEvent(const EventLog::Event &event);
+
+  /** Returns the modifier state (GLUT_ACTIVE_* flags) recorded at the
+      most recent mouse button event. Manipulators must use this
+      rather than calling glutGetModifiers() themselves, since the
+      events may not have come from GLUT. */
+  int getModifiers() const;
+
+  /** Returns the window into which a newly created manipulator
+      should be placed: the default window if one was set, otherwise
+      the current GLUT window. */
+  int getWindowForNewManip() const;
+
+  /** Returns true if called from the thread which owns the manager
+      (see init()) */
+  bool isOwningThread() const;
+
   /** Okay, okay. Here's the mapping from normalized screen
       coordinates to a 3D ray based on the camera parameters. You can
       feel free to replace this mapping with something more
-      sophisticated; you'll have to modify the CameraParameters data
-      structure, though. FIXME: update this to handle multiple
-      windows. */
+      sophisticated. This is the default mapping, used by all windows
+      which have not been given one of their own with the per-window
+      setScreenToRayMapping(), below. Setting it recomputes the ray
+      bases of all windows. The caller retains ownership of the
+      mapping's memory. */
   ScreenToRayMapping *getScreenToRayMapping();
   void setScreenToRayMapping(ScreenToRayMapping *mapping);
 
   /** Remove a manipulator from the manager completely. */
   void removeManip(Manip *manip);
 
+  /** Arranges for manip->dispatchFrameCallbacks() to be called at
+      the start of the next render() */
+  void queueFrameCallbacks(Manip *manip);
+
+  /** The thread on which worker motion callbacks run, started on
+      first use */
+  ManipCallbackWorker *getCallbackWorker();
+
+  /** The threads set up by setTargetThreads(), or NULL if there are
+      none */
+  TaskPool *getTargetPool();
+
+  /** Called when a manipulator's screen size (see
+      Manip::setScreenSize()) changes or a manipulator with a screen
+      size moves. The scale factors of all windows are recomputed
+      before they are next used. May be called from any thread. */
+  void invalidateScreenScales();
+
   /** Get the camera parameters associated with a particular
       window. NOTE: since this is an internal method, asserts if the
       windowID was unknown. */
@@ -121,11 +374,9 @@ GLEEM_INTERNAL public:
 private:
   ManipManager();
 
-  void mouseMethod(int windowID, int button, int state, int x, int y);
-  void motionMethod(int windowID, int x, int y);
-  void passiveMotionMethod(int windowID, int x, int y);
-
-  static ManipManager *manipManager;
+  /** Set once, with compare-and-swap, by init() */
+  static ManipManager * volatile manipManager;
+  Thread::ID owningThread;
   ScreenToRayMapping *mapping;
 
   // To handle multiple windows, we keep a list of attached
@@ -142,12 +393,95 @@ private:
   typedef BasicHashtable<IntList, Manip *, ManipHashFunc *> ManipToWindowListTable;
   ManipToWindowListTable manipWindowTable;
 
-  // Hash table mapping window ID to CameraParameters structure
-  typedef BasicHashtable<CameraParameters, int, hash<int> > WindowToCameraParametersTable;
-  WindowToCameraParametersTable windowCameraTable;
+  // Per-window camera state: the parameters most recently passed to
+  // updateCameraParameters() and the ray bases derived from them
+  class CameraInfo
+  {
+  public:
+    CameraParameters params;
+    /** Maps normalized screen coordinates to rays */
+    ScreenToRayBasis basis;
+    /** Maps GLUT window coordinates to rays */
+    ScreenToRayBasis pixelBasis;
+    /** Mapping set for this window, or NULL to use the default */
+    ScreenToRayMapping *mapping;
+    /** False until updateCameraParameters() has been called */
+    bool paramsValid;
+    /** True if the bases are up to date; requires camera parameters
+	and a mapping */
+    bool basisValid;
+    /** The mapping's generation when the bases were computed */
+    unsigned long mappingGeneration;
+    /** True if the mapping is affine, so that rays are generated from
+	pixelBasis. Otherwise computeRay() calls the mapping for every
+	ray, the bases are only a linear approximation used for size
+	estimates, and no frustum culling is done. */
+    bool affine;
+    /** The volume visible in the window, computed with the bases and
+	used for culling */
+    Frustum viewFrustum;
+    /** Also computed with the bases, for estimating projected sizes:
+	one pixel at the center of the window spans unitsPerPixel +
+	depth * unitsPerPixelPerDepth world units at the given depth
+	along viewAxis from viewOrigin */
+    GleemV3f viewOrigin;
+    GleemV3f viewAxis;
+    float unitsPerPixel;
+    float unitsPerPixelPerDepth;
+    /** Scale factors, and the points they scale about, which keep the
+	window's manipulators at their screen sizes, parallel to its
+	ManipList; empty if none of them has a screen size */
+    vector<float> screenScales;
+    vector<GleemV3f> screenScaleCenters;
+    /** True if the scale factors are up to date with the camera and
+	with the manager's screenScalesGeneration */
+    bool screenScalesValid;
+    long screenScalesGeneration;
+  };
+
+  // Hash table mapping window ID to CameraInfo structure
+  typedef BasicHashtable<CameraInfo, int, hash<int> > WindowToCameraInfoTable;
+  WindowToCameraInfoTable windowCameraTable;
+
+#ifdef GLEEM_ENABLE_STATS
+  // Per-window instrumentation counters
+  class WindowStats
+  {
+  public:
+    /** The frame in progress */
+    ManipStats frame;
+    ManipStats lastFrame;
+    ManipStats total;
+    LatencyHistogram latency;
+    /** Arrival times of the events since the last render */
+    vector<GleemInt64> pendingEvents;
+  };
+  typedef BasicHashtable<WindowStats, int, hash<int> > WindowToStatsTable;
+  WindowToStatsTable windowStatsTable;
+
+  /** Returns the counters for the given window's frame in progress,
+      or NULL if the window is unknown */
+  ManipStats *getFrameStats(int windowID);
+
+  /** Note the arrival of an input event for the given window at the
+      given time */
+  void startStatsEvent(int windowID, GleemInt64 arrivalTime);
+
+  /** Finish the given window's frame in progress, recording the
+      latency of each event which arrived during it */
+  void endStatsFrame(int windowID);
+#endif
+
+  /** Recompute the ray bases of the given window from its camera
+      parameters and mapping */
+  void recomputeBasis(CameraInfo &info);
 
   // Convenience routines
 
+  /** Body of addManipToWindow(), without flushing the pending
+      manips */
+  bool attachManip(Manip *manip, int windowID);
+
   /** Ensure that an entry exists for manip. Does not create a new one
       if one already exists. */
   void createEntryForManip(Manip *manip);
@@ -172,16 +506,101 @@ private:
       ID, false if not. */
   bool findEntryForWindow(int windowID);
 
+  /** Intersect a ray with the given manipulators, skipping those
+      whose bounds it misses, and return the closest hit in
+      closestHit. Returns false if nothing was hit. */
+  bool pickClosest(ManipList &manips,
+		   CameraInfo &info,
+		   const GleemV3f &rayStart,
+		   const GleemV3f &rayDirection,
+		   HitPoint &closestHit);
+
+  /** Intersect a ray with the index'th manipulator of a window,
+      using its part table if it has one and is at full detail, and
+      append the hits to results. Applies the manipulator's screen
+      size scale factor, and reports the hits in world space. */
+  void intersectManip(const CameraInfo &info, int index, Manip *manip,
+		      const GleemV3f &rayStart,
+		      const GleemV3f &rayDirection,
+		      vector<HitPoint> &results);
+
+  /** Scratch storage for intersectRay() results; reused across picks
+      to avoid allocating on every mouse event */
+  vector<HitPoint> pickResults;
+  /** Scratch storage for pickRays() */
+  vector<pair<int, int> > pickRayOrder;
+
+  /** Body of passiveMotionMethod(), minus recording. Also called
+      after a drag ends. */
+  void updateHighlight(int windowID, int x, int y);
+
+  /** Records an event if recording and not replaying */
+  void recordEvent(const EventLog::Event &event);
+
+  EventLog eventLog;
+  bool replaying;
+
+  // Manipulators queued since the last flushPendingManips(). Any
+  // number of threads push onto the front of this list with
+  // compare-and-swap; the owning thread takes the whole list at once,
+  // which avoids the ABA problem, and reverses it to restore creation
+  // order.
+  class PendingManip
+  {
+  public:
+    Manip *manip;
+    int windowID;
+    PendingManip *next;
+  };
+  PendingManip * volatile pendingManips;
+
+  /** Manipulators dragged since the last frame which have
+      ONCE_PER_FRAME motion callbacks */
+  vector<Manip *> frameCallbackManips;
+  void dispatchFrameCallbacks();
+  ManipCallbackWorker *callbackWorker;
+  TaskPool *targetPool;
+
+  int defaultWindow;
+  bool partArenasEnabled;
+  bool partTablesEnabled;
+  bool frustumCullingEnabled;
+  float detailBoxPixels;
+  float detailPointPixels;
+
+  /** Sets manip's level of detail for the window with the given
+      camera from the projected size of bsph, its bounds, or to full
+      detail if haveBounds is false */
+  void updateDetailLevel(const CameraInfo &info, Manip *manip,
+			 bool haveBounds, const BSphere &bsph);
+
+  /** Incremented, atomically, whenever the manipulators of any window
+      or their screen sizes or positions change */
+  volatile long screenScalesGeneration;
+  /** Recomputes the screen size scale factors of the window with the
+      given camera and manipulators if they are out of date */
+  void updateScreenScales(CameraInfo &info, const ManipList &manips);
+  /** Structure-of-arrays scratch storage for updateScreenScales() */
+  vector<float> screenScaleScratch;
+  /** Returns the scale factor of the index'th manipulator of the
+      window, 1 if it has none */
+  float getScreenScale(const CameraInfo &info, int index) const;
+  /** Applies the scale factor of the index'th manipulator of the
+      window to its bounds */
+  void scaleBounds(const CameraInfo &info, int index, BSphere &bsph) const;
+  int modifiers;
   bool dragging;
   Manip *curManip;
   Manip *curHighlightedManip;
 
-  GleemV2f screenToNormalizedCoordinates(const CameraParameters &params,
-					int x, int y);
-  bool computeRay(const CameraParameters &params,
+  bool computeRay(const CameraInfo &info,
 		  int x, int y,
 		  GleemV3f &raySource,
 		  GleemV3f &rayDirection);
+  /** Converts GLUT window coordinates to the normalized coordinates
+      taken by ScreenToRayMapping */
+  static GleemV2f screenToNormalizedCoordinates(const CameraParameters &params,
+						int x, int y);
 };
 
 GLEEM_EXIT_NAMESPACE
@@ -5,16 +5,91 @@
  */
 
 #include <gleem/ManipPart.h>
+#include <gleem/ManipPartArena.h>
+#include <gleem/ManipPartTable.h>
 
 GLEEM_USE_NAMESPACE
 
 ManipPart::ManipPart(Manip *parent)
 {
   setParent(parent);
+  table = NULL;
+  tableBegin = 0;
+  tableEnd = 0;
 }
 
 ManipPart::~ManipPart()
 {
+  // The table no longer matches the part trees
+  if (table != NULL)
+    table->clear();
+}
+
+// Every ManipPart is preceded by a header recording the arena it was
+// allocated from, or NULL if it came from the heap, so that operator
+// delete knows what to do with it. The header is padded to keep the
+// object aligned.
+union ManipPartHeader
+{
+  ManipPartArena *arena;
+  char pad[ManipPartArena::ALIGNMENT];
+};
+
+void *
+ManipPart::allocate(size_t size, ManipPartArena *arena)
+{
+  size += sizeof(ManipPartHeader);
+  ManipPartHeader *header;
+  if (arena != NULL)
+    header = (ManipPartHeader *) arena->allocate(size);
+  else
+    header = (ManipPartHeader *) ::operator new(size);
+  header->arena = arena;
+  return header + 1;
+}
+
+void *
+ManipPart::operator new(size_t size)
+{
+  return allocate(size, NULL);
+}
+
+void *
+ManipPart::operator new(size_t size, ManipPartArena *arena)
+{
+  return allocate(size, arena);
+}
+
+void
+ManipPart::operator delete(void *ptr)
+{
+  if (ptr == NULL)
+    return;
+  ManipPartHeader *header = ((ManipPartHeader *) ptr) - 1;
+  // Arena memory is reclaimed all at once by the arena
+  if (header->arena == NULL)
+    ::operator delete(header);
+}
+
+void
+ManipPart::operator delete(void *ptr, ManipPartArena *arena)
+{
+  ManipPart::operator delete(ptr);
+}
+
+bool
+ManipPart::getBoundingSphere(BSphere &bsph) const
+{
+  return false;
+}
+
+bool
+ManipPart::intersectFrustum(const Frustum &frustum) const
+{
+  BSphere bsph;
+  if (!getPickable() || !getBoundingSphere(bsph))
+    return false;
+  return frustum.intersectsSphere(bsph);
 }
 
 void
@@ -28,3 +103,47 @@ ManipPart::getParent() const
 {
   return parent;
 }
+
+void
+ManipPart::addToTable(ManipPartTable &table, ManipPart *reportAs,
+		      const GleemMat4f *localXform)
+{
+  int index = table.addEntry(this, reportAs, NULL,
+			     ManipPartTable::VISIBLE |
+			     ManipPartTable::PICKABLE,
+			     localXform);
+  table.addMember(this, index, index + 1);
+}
+
+void
+ManipPart::setTableLocalTransform(const GleemMat4f *localXform)
+{
+  if (table != NULL)
+    table->setLocalTransform(tableBegin, localXform);
+}
+
+void
+ManipPart::setTable(ManipPartTable *table, int begin, int end)
+{
+  this->table = table;
+  tableBegin = begin;
+  tableEnd = end;
+}
+
+ManipPartTable *
+ManipPart::getTable() const
+{
+  return table;
+}
+
+int
+ManipPart::getTableBegin() const
+{
+  return tableBegin;
+}
+
+int
+ManipPart::getTableEnd() const
+{
+  return tableEnd;
+}
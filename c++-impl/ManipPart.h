@@ -7,22 +7,34 @@
 #ifndef _GLEEM_MANIP_PART_H
 #define _GLEEM_MANIP_PART_H
 
+#include <stddef.h>
 #include <bool.h>
 #include <vector.h>
 #include <gleem/Namespace.h>
 #include <gleem/GleemDLL.h>
 #include <gleem/Util.h>
 #include <gleem/HitPoint.h>
+#include <gleem/BSphere.h>
+#include <gleem/Frustum.h>
 #include <gleem/Linalg.h>
 
 GLEEM_ENTER_NAMESPACE
 
 class Manip;
+class ManipPartArena;
+class ManipPartTable;
 
 /** A ManipPart is a visible or invisible sub-part of a manipulator.
     There are only a few necessary methods: render(), intersectRay(),
     and setTransform(). highlight() and clearHighlight() are merely
-    for visual feedback and do not need to be implemented. */
+    for visual feedback and do not need to be implemented.
+
+    ManipParts may be allocated either on the heap, with plain new,
+    or in a ManipPartArena, with new (arena). Either way they are
+    destroyed with delete; for parts in an arena this runs the
+    destructor and leaves the memory to be reclaimed when the arena is
+    reset or destroyed. Passing a NULL arena is the same as plain
+    new. */
 
 GLEEM_INTERNAL class GLEEMDLL ManipPart
 {
@@ -30,6 +42,13 @@ public:
   ManipPart(Manip *parent);
   virtual ~ManipPart();
 
+  /** Allocation on the heap or in an arena; see above */
+  void *operator new(size_t size);
+  void *operator new(size_t size, ManipPartArena *arena);
+  void operator delete(void *ptr);
+  /** Only called if a constructor fails */
+  void operator delete(void *ptr, ManipPartArena *arena);
+
   /** Render this part using OpenGL */
   virtual void render() const = 0;
 
@@ -59,6 +78,18 @@ public:
   virtual void setVisible(bool visible) = 0;
   virtual bool getVisible() const = 0;
 
+  /** Compute a world-space bounding sphere for this part's geometry
+      as of the last call to setTransform(). Returns false if the part
+      can not supply bounds, in which case callers must assume it may
+      be hit anywhere. The default implementation returns false. */
+  virtual bool getBoundingSphere(BSphere &bsph) const;
+
+  /** Returns true if any pickable portion of this part lies within
+      the given frustum. Used for marquee selection. The default
+      implementation tests the bounding sphere of pickable parts and
+      returns false for parts without bounds. */
+  virtual bool intersectFrustum(const Frustum &frustum) const;
+
 GLEEM_INTERNAL public:
   /** Set the parent of this ManipPart */
   void setParent(Manip *parent);
@@ -66,8 +97,39 @@ GLEEM_INTERNAL public:
   /** Get the containing Manip for constructing HitPoints */
   Manip *getParent() const;
 
+  /** Add entries for this part, or the leaves below it, to the given
+      table, reporting their hits as hits on reportAs, and register
+      with the table; see ManipPartTable. localXform is the product of
+      the offsets of the ManipPartTransforms above this part, or NULL
+      if there are none. The default implementation adds one entry
+      without a mesh, so the table calls this part's render(),
+      setTransform(), intersectRay() and intersectFrustum(). Groups
+      which do more than pass these on to their children must
+      override this to do the same. */
+  virtual void addToTable(ManipPartTable &table, ManipPart *reportAs,
+			  const GleemMat4f *localXform);
+
+  /** Called on a registered part when an offset above it has
+      changed; localXform is as in addToTable(). The default
+      implementation updates this part's entry. */
+  virtual void setTableLocalTransform(const GleemMat4f *localXform);
+
+  /** The table this part is registered in, if any, and the range of
+      entries it owns */
+  void setTable(ManipPartTable *table, int begin, int end);
+  ManipPartTable *getTable() const;
+  int getTableBegin() const;
+  int getTableEnd() const;
+
 private:
+  /** Allocates size bytes preceded by a header recording the arena,
+      if any */
+  static void *allocate(size_t size, ManipPartArena *arena);
+
   Manip *parent;
+  ManipPartTable *table;
+  int tableBegin;
+  int tableEnd;
 };
 
 GLEEM_EXIT_NAMESPACE
@@ -0,0 +1,81 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <gleem/ManipPartArena.h>
+
+GLEEM_USE_NAMESPACE
+
+ManipPartArena::ManipPartArena(size_t blockSize)
+{
+  this->blockSize = blockSize;
+  blocks = NULL;
+  cur = NULL;
+  end = NULL;
+  bytesUsed = 0;
+  numBlocks = 0;
+}
+
+ManipPartArena::~ManipPartArena()
+{
+  reset();
+}
+
+void *
+ManipPartArena::allocate(size_t size)
+{
+  size = (size + ALIGNMENT - 1) & ~((size_t) ALIGNMENT - 1);
+  if ((cur == NULL) || ((size_t) (end - cur) < size))
+    {
+      size_t dataSize = (size > blockSize) ? size : blockSize;
+      Block *block = (Block *) ::operator new(sizeof(Block) + dataSize);
+      char *data = (char *) (block + 1);
+      if ((size > blockSize) && (blocks != NULL))
+	{
+	  // Oversized request; keep filling the current block
+	  block->next = blocks->next;
+	  blocks->next = block;
+	  ++numBlocks;
+	  bytesUsed += size;
+	  return data;
+	}
+      block->next = blocks;
+      blocks = block;
+      cur = data;
+      end = data + dataSize;
+      ++numBlocks;
+    }
+  void *res = cur;
+  cur += size;
+  bytesUsed += size;
+  return res;
+}
+
+void
+ManipPartArena::reset()
+{
+  while (blocks != NULL)
+    {
+      Block *next = blocks->next;
+      ::operator delete(blocks);
+      blocks = next;
+    }
+  cur = NULL;
+  end = NULL;
+  bytesUsed = 0;
+  numBlocks = 0;
+}
+
+size_t
+ManipPartArena::getBytesUsed() const
+{
+  return bytesUsed;
+}
+
+int
+ManipPartArena::getNumBlocks() const
+{
+  return numBlocks;
+}
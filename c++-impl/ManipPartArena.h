@@ -0,0 +1,77 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_MANIP_PART_ARENA_H
+#define _GLEEM_MANIP_PART_ARENA_H
+
+#include <stddef.h>
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+
+GLEEM_ENTER_NAMESPACE
+
+/** A bump allocator for ManipParts. Memory is carved sequentially out
+    of large blocks, so all the parts of a manipulator end up next to
+    each other, and is only returned, all at once, by reset() or the
+    destructor. Individual allocations are never freed. Parts are
+    placed in an arena with new (arena) SomePart(...) and deleted as
+    usual; deleting them runs their destructors but leaves the memory
+    in the arena. Not thread-safe. */
+
+GLEEM_INTERNAL class GLEEMDLL ManipPartArena
+{
+public:
+  enum { DEFAULT_BLOCK_SIZE = 16384 };
+
+  /** Requests larger than blockSize get a block of their own */
+  ManipPartArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+  /** Frees all blocks. All objects allocated from this arena must
+      already have been destroyed. */
+  ~ManipPartArena();
+
+  /** Returns size bytes of memory, aligned as strictly as memory
+      from operator new. Sizes are rounded up to a multiple of
+      ALIGNMENT bytes. */
+  void *allocate(size_t size);
+
+  /** Frees all blocks. All objects allocated from this arena must
+      already have been destroyed. */
+  void reset();
+
+  /** Total number of bytes handed out since construction or the last
+      reset(), including alignment padding */
+  size_t getBytesUsed() const;
+
+  /** Number of blocks currently held */
+  int getNumBlocks() const;
+
+  enum { ALIGNMENT = 16 };
+
+private:
+  class Block
+  {
+  public:
+    Block *next;
+    // Pad the header so the data following it is aligned
+    char pad[ALIGNMENT - sizeof(Block *)];
+  };
+
+  size_t blockSize;
+  Block *blocks;
+  char *cur;
+  char *end;
+  size_t bytesUsed;
+  int numBlocks;
+
+  // Not copyable
+  ManipPartArena(const ManipPartArena &);
+  ManipPartArena &operator=(const ManipPartArena &);
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_MANIP_PART_ARENA_H
@@ -5,27 +5,31 @@
  */
 
 #include <gleem/ManipPartCube.h>
-#include <gleem/NormalCalc.h>
 
 GLEEM_USE_NAMESPACE
 
-float
-ManipPartCube::verticesAsFloats[][3] = {
+// The normal and edge tables are derived from the vertex and index
+// tables, exactly as NormalCalc::computeFacetedNormals() would compute
+// the normals (counterclockwise triangles), and must be regenerated if
+// those change. Being constant data they need no allocation or
+// initialization at run time.
+
+const float
+ManipPartCube::verticesAsFloats[][GLEEM_V3F_STRIDE] = {
   // Front side
-  {-1, 1, 1},
-  {-1, -1, 1},
-  {1, -1, 1},
-  {1, 1, 1},
+  GLEEM_V3F_INIT(-1, 1, 1),
+  GLEEM_V3F_INIT(-1, -1, 1),
+  GLEEM_V3F_INIT(1, -1, 1),
+  GLEEM_V3F_INIT(1, 1, 1),
   // Back side
-  {-1, 1, -1},
-  {-1, -1, -1},
-  {1, -1, -1},
-  {1, 1, -1}
+  GLEEM_V3F_INIT(-1, 1, -1),
+  GLEEM_V3F_INIT(-1, -1, -1),
+  GLEEM_V3F_INIT(1, -1, -1),
+  GLEEM_V3F_INIT(1, 1, -1)
 };
-GleemV3f *ManipPartCube::vertices = NULL;
-int ManipPartCube::numVertices = 8;
+const int ManipPartCube::numVertices = 8;
 
-int
+const int
 ManipPartCube::vertexIndices[] = {
   // Front face
   0, 1, 2, -1,
@@ -46,42 +50,78 @@ ManipPartCube::vertexIndices[] = {
   1, 5, 6, -1,
   1, 6, 2, -1
 };
-int ManipPartCube::numVertexIndices = 48;
+const int ManipPartCube::numVertexIndices = 48;
+
+const float
+ManipPartCube::normalsAsFloats[][GLEEM_V3F_STRIDE] = {
+  GLEEM_V3F_INIT(0, 0, 1),
+  GLEEM_V3F_INIT(0, 0, 1),
+  GLEEM_V3F_INIT(1, 0, 0),
+  GLEEM_V3F_INIT(1, 0, 0),
+  GLEEM_V3F_INIT(0, 0, -1),
+  GLEEM_V3F_INIT(0, 0, -1),
+  GLEEM_V3F_INIT(-1, 0, 0),
+  GLEEM_V3F_INIT(-1, 0, 0),
+  GLEEM_V3F_INIT(0, 1, 0),
+  GLEEM_V3F_INIT(0, 1, 0),
+  GLEEM_V3F_INIT(0, -1, 0),
+  GLEEM_V3F_INIT(0, -1, 0)
+};
+const int ManipPartCube::numNormals = 12;
 
-GleemV3f *
-ManipPartCube::normals = NULL;
-int ManipPartCube::numNormals = 0;
+const int
+ManipPartCube::normalIndices[] = {
+  0, 0, 0, -1,
+  1, 1, 1, -1,
+  2, 2, 2, -1,
+  3, 3, 3, -1,
+  4, 4, 4, -1,
+  5, 5, 5, -1,
+  6, 6, 6, -1,
+  7, 7, 7, -1,
+  8, 8, 8, -1,
+  9, 9, 9, -1,
+  10, 10, 10, -1,
+  11, 11, 11, -1
+};
+const int ManipPartCube::numNormalIndices = 48;
 
-int *ManipPartCube::normalIndices = NULL;
-int ManipPartCube::numNormalIndices = 0;
+const float
+ManipPartCube::edgesAsFloats[][GLEEM_V3F_STRIDE] = {
+  GLEEM_V3F_INIT(0, -2, 0),
+  GLEEM_V3F_INIT(2, -2, 0),
+  GLEEM_V3F_INIT(2, -2, 0),
+  GLEEM_V3F_INIT(2, 0, 0),
+  GLEEM_V3F_INIT(0, -2, 0),
+  GLEEM_V3F_INIT(0, -2, -2),
+  GLEEM_V3F_INIT(0, -2, -2),
+  GLEEM_V3F_INIT(0, 0, -2),
+  GLEEM_V3F_INIT(0, -2, 0),
+  GLEEM_V3F_INIT(-2, -2, 0),
+  GLEEM_V3F_INIT(-2, -2, 0),
+  GLEEM_V3F_INIT(-2, 0, 0),
+  GLEEM_V3F_INIT(0, -2, 0),
+  GLEEM_V3F_INIT(0, -2, 2),
+  GLEEM_V3F_INIT(0, -2, 2),
+  GLEEM_V3F_INIT(0, 0, 2),
+  GLEEM_V3F_INIT(0, 0, 2),
+  GLEEM_V3F_INIT(2, 0, 2),
+  GLEEM_V3F_INIT(2, 0, 2),
+  GLEEM_V3F_INIT(2, 0, 0),
+  GLEEM_V3F_INIT(0, 0, -2),
+  GLEEM_V3F_INIT(2, 0, -2),
+  GLEEM_V3F_INIT(2, 0, -2),
+  GLEEM_V3F_INIT(2, 0, 0)
+};
 
 ManipPartCube::ManipPartCube(Manip *parent) :
   ManipPartTriBased(parent)
 {
-  // FIXME: not thread safe
-  if (vertices == NULL)
-    {
-      vertices = new GleemV3f[numVertices];
-      for (int i = 0; i < numVertices; i++)
-	vertices[i].setValue(verticesAsFloats[i][0],
-			     verticesAsFloats[i][1],
-			     verticesAsFloats[i][2]);
-
-      bool result = NormalCalc::computeFacetedNormals(vertices,
-						      numVertices,
-						      vertexIndices,
-						      numVertexIndices,
-						      true,
-						      normals,
-						      numNormals,
-						      normalIndices,
-						      numNormalIndices);
-      assert(result == true);
-    }
-  setVertices(vertices, numVertices);
+  setVertices((const GleemV3f *) verticesAsFloats, numVertices);
   setVertexIndices(vertexIndices, numVertexIndices);
-  setNormals(normals, numNormals);
+  setNormals((const GleemV3f *) normalsAsFloats, numNormals);
   setNormalIndices(normalIndices, numNormalIndices);
+  setEdges((const GleemV3f *) edgesAsFloats);
 }
 
 ManipPartCube::~ManipPartCube()
@@ -24,15 +24,17 @@ public:
   virtual ~ManipPartCube();
 
 private:
-  static float verticesAsFloats[][3];
-  static GleemV3f *vertices;
-  static int numVertices;
-  static int vertexIndices[];
-  static int numVertexIndices;
-  static GleemV3f *normals;
-  static int numNormals;
-  static int *normalIndices;
-  static int numNormalIndices;
+  static const float verticesAsFloats[][GLEEM_V3F_STRIDE];
+  static const int numVertices;
+  static const int vertexIndices[];
+  static const int numVertexIndices;
+  /** One faceted normal per triangle */
+  static const float normalsAsFloats[][GLEEM_V3F_STRIDE];
+  static const int numNormals;
+  static const int normalIndices[];
+  static const int numNormalIndices;
+  /** Two edges per triangle; see ManipPartTriBased::setEdges() */
+  static const float edgesAsFloats[][GLEEM_V3F_STRIDE];
 };
 
 GLEEM_EXIT_NAMESPACE
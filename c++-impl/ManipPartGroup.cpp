@@ -6,6 +6,8 @@
 
 #include <algo.h>
 #include <gleem/ManipPartGroup.h>
+#include <gleem/ManipPartTable.h>
+#include <gleem/ManipStats.h>
 
 GLEEM_USE_NAMESPACE
 
@@ -35,6 +37,7 @@ ManipPartGroup::intersectRay(const GleemV3f &rayStart,
 			     const GleemV3f &rayDirection,
 			     vector<HitPoint> &results)
 {
+  GLEEM_STATS_INC(partsVisited);
   if (!pickable)
     return;
   int topIdx = results.size();
@@ -71,6 +74,9 @@ ManipPartGroup::clearHighlight()
 void
 ManipPartGroup::setPickable(bool pickable)
 {
+  if ((getTable() != NULL) && (pickable != this->pickable))
+    getTable()->blockFlag(getTableBegin(), getTableEnd(),
+			  ManipPartTable::PICKABLE, !pickable);
   this->pickable = pickable;
 }
 
@@ -83,6 +89,9 @@ ManipPartGroup::getPickable() const
 void
 ManipPartGroup::setVisible(bool visible)
 {
+  if ((getTable() != NULL) && (visible != this->visible))
+    getTable()->blockFlag(getTableBegin(), getTableEnd(),
+			  ManipPartTable::VISIBLE, !visible);
   this->visible = visible;
 }
 
@@ -92,11 +101,62 @@ ManipPartGroup::getVisible() const
   return visible;
 }
 
+bool
+ManipPartGroup::getBoundingSphere(BSphere &bsph) const
+{
+  if (parts.size() == 0)
+    return false;
+  bsph.makeEmpty();
+  BSphere childSph;
+  for (int i = 0; i < parts.size(); i++)
+    {
+      if (!parts[i]->getBoundingSphere(childSph))
+	return false;
+      bsph.extendBy(childSph);
+    }
+  return true;
+}
+
+bool
+ManipPartGroup::intersectFrustum(const Frustum &frustum) const
+{
+  if (!pickable)
+    return false;
+  for (int i = 0; i < parts.size(); i++)
+    if (parts[i]->intersectFrustum(frustum))
+      return true;
+  return false;
+}
+
+void
+ManipPartGroup::addToTable(ManipPartTable &table, ManipPart *reportAs,
+			   const GleemMat4f *localXform)
+{
+  int begin = table.getNumEntries();
+  for (int i = 0; i < parts.size(); i++)
+    parts[i]->addToTable(table, reportAs, localXform);
+  int end = table.getNumEntries();
+  table.addMember(this, begin, end);
+  if (!pickable)
+    table.blockFlag(begin, end, ManipPartTable::PICKABLE, true);
+  if (!visible)
+    table.blockFlag(begin, end, ManipPartTable::VISIBLE, true);
+}
+
+void
+ManipPartGroup::setTableLocalTransform(const GleemMat4f *localXform)
+{
+  for (int i = 0; i < parts.size(); i++)
+    parts[i]->setTableLocalTransform(localXform);
+}
+
 int
 ManipPartGroup::addPart(ManipPart *part)
 {
   if (part == NULL)
     return -1;
+  if (getTable() != NULL)
+    getTable()->clear();
   parts.push_back(part);
   return parts.size() - 1;
 }
@@ -108,6 +168,8 @@ ManipPartGroup::removePart(ManipPart *part)
     find(parts.begin(), parts.end(), part);
   if (iter == parts.end())
     return false;
+  if (getTable() != NULL)
+    getTable()->clear();
   parts.erase(iter);
   return true;
 }
@@ -117,6 +179,8 @@ ManipPartGroup::removePart(int i)
 {
   if ((i < 0) || (i >= parts.size()))
     return NULL;
+  if (getTable() != NULL)
+    getTable()->clear();
   ManipPart *part = parts[i];
   parts.erase(parts.begin() + i);
   return part;
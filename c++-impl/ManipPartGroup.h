@@ -38,14 +38,25 @@ public:
   /** Default is visible */
   virtual void setVisible(bool visible);
   virtual bool getVisible() const;
+  /** Union of the children's bounds. Returns false if the group is
+      empty or any child can not supply bounds. */
+  virtual bool getBoundingSphere(BSphere &bsph) const;
+  /** Returns true if this group is pickable and any of its children
+      intersect the frustum */
+  virtual bool intersectFrustum(const Frustum &frustum) const;
+  /** Adds the children's entries */
+  virtual void addToTable(ManipPartTable &table, ManipPart *reportAs,
+			  const GleemMat4f *localXform);
+  virtual void setTableLocalTransform(const GleemMat4f *localXform);
 
   // Group-specific functions
 
   /** Add this part to the group, returning its index. Returns -1 if
       part is NULL. NOTE: Group obtains ownership of ManipPart's
       memory and calls delete on it when the group is destroyed, so
-      ManipPart must be allocated with operator new. Multiple
-      references are not allowed. */
+      ManipPart must be allocated with operator new (possibly in a
+      ManipPartArena; see ManipPart). Multiple references are not
+      allowed. */
   int addPart(ManipPart *part);
   /** Remove the first instance (NOTE: you should not be adding
       multiple instances of any ManipPart to this group in the first
@@ -5,28 +5,29 @@
  */
 
 #include <gleem/ManipPartHollowCubeFace.h>
-#include <gleem/NormalCalc.h>
 
 GLEEM_USE_NAMESPACE
 
-float
-ManipPartHollowCubeFace::verticesAsFloats[][3] = {
+// Derived normal and edge tables follow the vertex and index tables;
+// see ManipPartCube.cpp.
+
+const float
+ManipPartHollowCubeFace::verticesAsFloats[][GLEEM_V3F_STRIDE] = {
   // Outer square, counter-clockwise, starting from upper left
-  {-1, 1, 0},
-  {-1, -1, 0},
-  {1, -1, 0},
-  {1, 1, 0},
+  GLEEM_V3F_INIT(-1, 1, 0),
+  GLEEM_V3F_INIT(-1, -1, 0),
+  GLEEM_V3F_INIT(1, -1, 0),
+  GLEEM_V3F_INIT(1, 1, 0),
 
   // Inner square, counter-clockwise, starting from upper left
-  {-0.9f, 0.9f, 0},
-  {-0.9f, -0.9f, 0},
-  {0.9f, -0.9f, 0},
-  {0.9f, 0.9f, 0}
+  GLEEM_V3F_INIT(-0.9f, 0.9f, 0),
+  GLEEM_V3F_INIT(-0.9f, -0.9f, 0),
+  GLEEM_V3F_INIT(0.9f, -0.9f, 0),
+  GLEEM_V3F_INIT(0.9f, 0.9f, 0)
 };
-GleemV3f *ManipPartHollowCubeFace::vertices = NULL;
-int ManipPartHollowCubeFace::numVertices = 8;
+const int ManipPartHollowCubeFace::numVertices = 8;
 
-int
+const int
 ManipPartHollowCubeFace::vertexIndices[] = {
   // Need both front and back faces.
   // Front face
@@ -39,42 +40,62 @@ ManipPartHollowCubeFace::vertexIndices[] = {
   7, 3, 0, -1,
   7, 0, 4, -1
 };
-int ManipPartHollowCubeFace::numVertexIndices = 32;
+const int ManipPartHollowCubeFace::numVertexIndices = 32;
+
+const float
+ManipPartHollowCubeFace::normalsAsFloats[][GLEEM_V3F_STRIDE] = {
+  GLEEM_V3F_INIT(0, 0, 1),
+  GLEEM_V3F_INIT(0, 0, 1),
+  GLEEM_V3F_INIT(0, 0, 1),
+  GLEEM_V3F_INIT(0, 0, 1),
+  GLEEM_V3F_INIT(0, 0, 1),
+  GLEEM_V3F_INIT(0, 0, 1),
+  GLEEM_V3F_INIT(0, 0, 1),
+  GLEEM_V3F_INIT(0, 0, 1)
+};
+const int ManipPartHollowCubeFace::numNormals = 8;
 
-GleemV3f *
-ManipPartHollowCubeFace::normals = NULL;
-int ManipPartHollowCubeFace::numNormals = 0;
+const int
+ManipPartHollowCubeFace::normalIndices[] = {
+  0, 0, 0, -1,
+  1, 1, 1, -1,
+  2, 2, 2, -1,
+  3, 3, 3, -1,
+  4, 4, 4, -1,
+  5, 5, 5, -1,
+  6, 6, 6, -1,
+  7, 7, 7, -1
+};
+const int ManipPartHollowCubeFace::numNormalIndices = 32;
 
-int *ManipPartHollowCubeFace::normalIndices = NULL;
-int ManipPartHollowCubeFace::numNormalIndices = 0;
+const float
+ManipPartHollowCubeFace::edgesAsFloats[][GLEEM_V3F_STRIDE] = {
+  GLEEM_V3F_INIT(-0.100000024f, 0.100000024f, 0),
+  GLEEM_V3F_INIT(-0.100000024f, -1.89999998f, 0),
+  GLEEM_V3F_INIT(-0.100000024f, -1.89999998f, 0),
+  GLEEM_V3F_INIT(0, -1.79999995f, 0),
+  GLEEM_V3F_INIT(-0.100000024f, -0.100000024f, 0),
+  GLEEM_V3F_INIT(1.89999998f, -0.100000024f, 0),
+  GLEEM_V3F_INIT(1.89999998f, -0.100000024f, 0),
+  GLEEM_V3F_INIT(1.79999995f, 0, 0),
+  GLEEM_V3F_INIT(0.100000024f, -0.100000024f, 0),
+  GLEEM_V3F_INIT(0.100000024f, 1.89999998f, 0),
+  GLEEM_V3F_INIT(0.100000024f, 1.89999998f, 0),
+  GLEEM_V3F_INIT(0, 1.79999995f, 0),
+  GLEEM_V3F_INIT(0.100000024f, 0.100000024f, 0),
+  GLEEM_V3F_INIT(-1.89999998f, 0.100000024f, 0),
+  GLEEM_V3F_INIT(-1.89999998f, 0.100000024f, 0),
+  GLEEM_V3F_INIT(-1.79999995f, 0, 0)
+};
 
 ManipPartHollowCubeFace::ManipPartHollowCubeFace(Manip *parent) :
   ManipPartTriBased(parent)
 {
-  // FIXME: not thread safe
-  if (vertices == NULL)
-    {
-      vertices = new GleemV3f[numVertices];
-      for (int i = 0; i < numVertices; i++)
-	vertices[i].setValue(verticesAsFloats[i][0],
-			     verticesAsFloats[i][1],
-			     verticesAsFloats[i][2]);
-
-      bool result = NormalCalc::computeFacetedNormals(vertices,
-						      numVertices,
-						      vertexIndices,
-						      numVertexIndices,
-						      true,
-						      normals,
-						      numNormals,
-						      normalIndices,
-						      numNormalIndices);
-      assert(result == true);
-    }
-  setVertices(vertices, numVertices);
+  setVertices((const GleemV3f *) verticesAsFloats, numVertices);
   setVertexIndices(vertexIndices, numVertexIndices);
-  setNormals(normals, numNormals);
+  setNormals((const GleemV3f *) normalsAsFloats, numNormals);
   setNormalIndices(normalIndices, numNormalIndices);
+  setEdges((const GleemV3f *) edgesAsFloats);
 }
 
 ManipPartHollowCubeFace::~ManipPartHollowCubeFace()
@@ -5,6 +5,8 @@
  */
 
 #include <gleem/ManipPartLineSeg.h>
+#include <gleem/ManipStats.h>
+#include <gleem/Trace.h>
 #ifdef WIN32
 # include <windows.h>
 #endif
@@ -12,31 +14,22 @@
 
 GLEEM_USE_NAMESPACE
 
-float
-ManipPartLineSeg::verticesAsFloats[][3] = {
-  {-1, 0, 0},
-  {1, 0, 0}
+const float
+ManipPartLineSeg::verticesAsFloats[][GLEEM_V3F_STRIDE] = {
+  GLEEM_V3F_INIT(-1, 0, 0),
+  GLEEM_V3F_INIT(1, 0, 0)
 };
-GleemV3f *ManipPartLineSeg::vertices = NULL;
-int ManipPartLineSeg::numVertices = 2;
+const int ManipPartLineSeg::numVertices = 2;
 
 ManipPartLineSeg::ManipPartLineSeg(Manip *parent) :
   ManipPart(parent)
 {
-  // FIXME: not thread safe
-  if (vertices == NULL)
-    {
-      vertices = new GleemV3f[numVertices];
-      for (int i = 0; i < numVertices; i++)
-	vertices[i].setValue(verticesAsFloats[i][0],
-			     verticesAsFloats[i][1],
-			     verticesAsFloats[i][2]);
-    }
   color.setValue(0.8f, 0.8f, 0.8f);
   highlightColor.setValue(0.8f, 0.8f, 0);
   highlighted = false;
   visible = true;
   xform.makeIdent();
+  numTranslations = 0;
   recalcVertices();
 }
 
@@ -92,12 +85,30 @@ ManipPartLineSeg::intersectRay(const GleemV3f &rayStart,
 			       const GleemV3f &rayDirection,
 			       vector<HitPoint> &results)
 {
+  GLEEM_STATS_INC(partsVisited);
 }
 
 void
 ManipPartLineSeg::setTransform(const GleemMat4f &xform)
 {
+  if ((numTranslations < MAX_TRANSLATIONS) &&
+      xform.equalExceptTranslation(this->xform))
+    {
+      // Move the transformed vertices and bounds rigidly
+      GleemV3f delta(xform[0][3] - this->xform[0][3],
+		     xform[1][3] - this->xform[1][3],
+		     xform[2][3] - this->xform[2][3]);
+      if ((delta[0] == 0) && (delta[1] == 0) && (delta[2] == 0))
+	return;
+      this->xform = xform;
+      for (int i = 0; i < curVertices.size(); i++)
+	curVertices[i] += delta;
+      bounds.setCenter(bounds.getCenter() + delta);
+      ++numTranslations;
+      return;
+    }
   this->xform = xform;
+  numTranslations = 0;
   recalcVertices();
 }
 
@@ -136,19 +147,27 @@ ManipPartLineSeg::getVisible() const
   return visible;
 }
 
+bool
+ManipPartLineSeg::getBoundingSphere(BSphere &bsph) const
+{
+  bsph = bounds;
+  return true;
+}
+
 void
 ManipPartLineSeg::recalcVertices()
 {
+  GLEEM_TRACE_SCOPE("ManipPartLineSeg::recalcVertices", this);
   curVertices.erase(curVertices.begin(), curVertices.end());
   curNormals.erase(curNormals.begin(), curNormals.end());
-  GleemV3f v, n;
-  GleemV3f vNew, nNew;
+  const GleemV3f *vertices = (const GleemV3f *) verticesAsFloats;
+  GleemV3f vNew;
   int i;
   for (i = 0; i < numVertices; i++)
     {
-      v = vertices[i];
-      xform.xformPt(v, vNew);
+      xform.xformPt(vertices[i], vNew);
       curVertices.push_back(vNew);
     }
   assert(numVertices == curVertices.size());
+  bounds.makeFromPoints((GleemV3f *) curVertices.begin(), numVertices);
 }
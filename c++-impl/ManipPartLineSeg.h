@@ -47,8 +47,15 @@ public:
   /** Default is visible */
   virtual void setVisible(bool visible);
   virtual bool getVisible() const;
+  virtual bool getBoundingSphere(BSphere &bsph) const;
 
 private:
+  enum
+  {
+    /** See ManipPartTriBased */
+    MAX_TRANSLATIONS = 64
+  };
+
   void recalcVertices();
 
   GleemV3f color;
@@ -57,14 +64,18 @@ private:
   bool visible;
   /** Current transformation matrix */
   GleemMat4f xform;
+  /** Translation-only updates since curVertices were last computed
+      from scratch */
+  int numTranslations;
   /** Transformed vertices */
   vector<GleemV3f> curVertices;
+  /** Bounds of the transformed vertices */
+  BSphere bounds;
   /** Transformed normals */
   vector<GleemV3f> curNormals;
 
-  static float verticesAsFloats[][3];
-  static GleemV3f *vertices;
-  static int numVertices;
+  static const float verticesAsFloats[][GLEEM_V3F_STRIDE];
+  static const int numVertices;
 };
 
 GLEEM_EXIT_NAMESPACE
@@ -0,0 +1,84 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <assert.h>
+#include <gleem/ManipPartMesh.h>
+#include <gleem/RayTriangleIntersection.h>
+
+GLEEM_USE_NAMESPACE
+
+ManipPartMesh::ManipPartMesh()
+{
+  vertices = NULL;
+  numVertices = 0;
+  normals = NULL;
+  numNormals = 0;
+  vertexIndices = NULL;
+  numVertexIndices = 0;
+  normalIndices = NULL;
+  numNormalIndices = 0;
+  edges = NULL;
+}
+
+int
+ManipPartMesh::intersectRay(const GleemV3f &rayStart,
+			    const GleemV3f &rayDirection,
+			    const GleemV3f *testVertices,
+			    const GleemMat4f *toWorld,
+			    HitPoint &hit,
+			    vector<HitPoint> &results) const
+{
+  // The precomputed edges only apply to the untransformed vertices
+  const GleemV3f *testEdges = edges;
+  if (testVertices == NULL)
+    testVertices = vertices;
+  else
+    testEdges = NULL;
+  GleemV3f intPt;
+  float t;
+  GleemV3f edge1, edge2;
+  const GleemV3f *e1, *e2;
+  for (int i = 0; i < numVertexIndices; i+=4)
+    {
+      int i0 = vertexIndices[i];
+      assert(vertexIndices[i+3] == -1);
+      const GleemV3f &v0 = testVertices[i0];
+      if (testEdges != NULL)
+	{
+	  e1 = &testEdges[i / 2];
+	  e2 = &testEdges[i / 2 + 1];
+	}
+      else
+	{
+	  GleemV3f::sub(testVertices[vertexIndices[i+1]], v0, edge1);
+	  GleemV3f::sub(testVertices[vertexIndices[i+2]], v0, edge2);
+	  e1 = &edge1;
+	  e2 = &edge2;
+	}
+      if (RayTriangleIntersection::
+	  intersectRayWithTriangleEdges(rayStart,
+					rayDirection,
+					v0,
+					*e1,
+					*e2,
+					intPt,
+					t)
+	  == RayTriangleIntersection::RTI_INTERSECTION)
+	{
+	  // Check for intersections behind the ray
+	  if (t >= 0)
+	    {
+	      if (toWorld != NULL)
+		toWorld->xformPt(intPt, hit.intPt);
+	      else
+		hit.intPt = intPt;
+	      hit.t = t;
+	      results.push_back(hit);
+	    }
+	}
+    }
+  return numVertexIndices / 4;
+}
@@ -0,0 +1,59 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_MANIP_PART_MESH_H
+#define _GLEEM_MANIP_PART_MESH_H
+
+#include <vector.h>
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+#include <gleem/HitPoint.h>
+#include <gleem/Linalg.h>
+
+GLEEM_ENTER_NAMESPACE
+
+/** Untransformed triangle geometry of a ManipPartTriBased. Only
+    points to its arrays, which typically are static tables shared by
+    all parts of the same shape; see ManipPartTriBased for their
+    layout. */
+
+GLEEM_INTERNAL class GLEEMDLL ManipPartMesh
+{
+public:
+  /** Default constructor produces an empty mesh */
+  ManipPartMesh();
+
+  /** Intersects a ray with the mesh's triangles. If testVertices is
+      NULL the ray must be given in the mesh's own coordinate system,
+      and is tested against vertices (and edges, if present);
+      otherwise it is tested against testVertices, which must be
+      indexed like vertices. For each intersection at or ahead of the
+      ray start, appends a copy of hit to results with t and intPt
+      filled in. intPt is transformed by toWorld if it is not NULL.
+      Returns the number of triangles tested. */
+  int intersectRay(const GleemV3f &rayStart,
+		   const GleemV3f &rayDirection,
+		   const GleemV3f *testVertices,
+		   const GleemMat4f *toWorld,
+		   HitPoint &hit,
+		   vector<HitPoint> &results) const;
+
+  const GleemV3f *vertices;
+  int numVertices;
+  const GleemV3f *normals;
+  int numNormals;
+  const int *vertexIndices;
+  int numVertexIndices;
+  const int *normalIndices;
+  int numNormalIndices;
+  /** Optional; two per triangle */
+  const GleemV3f *edges;
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_MANIP_PART_MESH_H
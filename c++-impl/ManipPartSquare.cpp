@@ -5,63 +5,60 @@
  */
 
 #include <gleem/ManipPartSquare.h>
-#include <gleem/NormalCalc.h>
 
 GLEEM_USE_NAMESPACE
 
-float
-ManipPartSquare::verticesAsFloats[][3] = {
+// As in ManipPartCube, the normal and edge tables below are derived
+// from the vertices and indices and must be kept in sync with them.
+
+const float
+ManipPartSquare::verticesAsFloats[][GLEEM_V3F_STRIDE] = {
   // Counter-clockwise, starting from upper left
-  {-1, 1, 0},
-  {-1, -1, 0},
-  {1, -1, 0},
-  {1, 1, 0}
+  GLEEM_V3F_INIT(-1, 1, 0),
+  GLEEM_V3F_INIT(-1, -1, 0),
+  GLEEM_V3F_INIT(1, -1, 0),
+  GLEEM_V3F_INIT(1, 1, 0)
 };
-GleemV3f *ManipPartSquare::vertices = NULL;
-int ManipPartSquare::numVertices = 4;
+const int ManipPartSquare::numVertices = 4;
 
-int
+const int
 ManipPartSquare::vertexIndices[] = {
   // Just the front face
   0, 1, 2, -1,
   0, 2, 3, -1
 };
-int ManipPartSquare::numVertexIndices = 8;
+const int ManipPartSquare::numVertexIndices = 8;
+
+const float
+ManipPartSquare::normalsAsFloats[][GLEEM_V3F_STRIDE] = {
+  GLEEM_V3F_INIT(0, 0, 1),
+  GLEEM_V3F_INIT(0, 0, 1)
+};
+const int ManipPartSquare::numNormals = 2;
 
-GleemV3f *
-ManipPartSquare::normals = NULL;
-int ManipPartSquare::numNormals = 0;
+const int
+ManipPartSquare::normalIndices[] = {
+  0, 0, 0, -1,
+  1, 1, 1, -1
+};
+const int ManipPartSquare::numNormalIndices = 8;
 
-int *ManipPartSquare::normalIndices = NULL;
-int ManipPartSquare::numNormalIndices = 0;
+const float
+ManipPartSquare::edgesAsFloats[][GLEEM_V3F_STRIDE] = {
+  GLEEM_V3F_INIT(0, -2, 0),
+  GLEEM_V3F_INIT(2, -2, 0),
+  GLEEM_V3F_INIT(2, -2, 0),
+  GLEEM_V3F_INIT(2, 0, 0)
+};
 
 ManipPartSquare::ManipPartSquare(Manip *parent) :
   ManipPartTriBased(parent)
 {
-  // FIXME: not thread safe
-  if (vertices == NULL)
-    {
-      vertices = new GleemV3f[numVertices];
-      for (int i = 0; i < numVertices; i++)
-	vertices[i].setValue(verticesAsFloats[i][0],
-			     verticesAsFloats[i][1],
-			     verticesAsFloats[i][2]);
-
-      bool result = NormalCalc::computeFacetedNormals(vertices,
-						      numVertices,
-						      vertexIndices,
-						      numVertexIndices,
-						      true,
-						      normals,
-						      numNormals,
-						      normalIndices,
-						      numNormalIndices);
-      assert(result == true);
-    }
-  setVertices(vertices, numVertices);
+  setVertices((const GleemV3f *) verticesAsFloats, numVertices);
   setVertexIndices(vertexIndices, numVertexIndices);
-  setNormals(normals, numNormals);
+  setNormals((const GleemV3f *) normalsAsFloats, numNormals);
   setNormalIndices(normalIndices, numNormalIndices);
+  setEdges((const GleemV3f *) edgesAsFloats);
 }
 
 ManipPartSquare::~ManipPartSquare()
@@ -0,0 +1,339 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <assert.h>
+#include <gleem/ManipPartTable.h>
+#include <gleem/ManipPart.h>
+#include <gleem/ManipPartMesh.h>
+#include <gleem/ManipStats.h>
+
+GLEEM_USE_NAMESPACE
+
+ManipPartTable::ManipPartTable()
+{
+  valid = true;
+  rootXformValid = false;
+}
+
+ManipPartTable::~ManipPartTable()
+{
+  clear();
+}
+
+void
+ManipPartTable::addPickRoot(ManipPart *root)
+{
+  addRoot(root, true);
+}
+
+void
+ManipPartTable::addRenderRoot(ManipPart *root)
+{
+  addRoot(root, false);
+}
+
+void
+ManipPartTable::clear()
+{
+  for (int i = 0; i < members.size(); i++)
+    members[i]->setTable(NULL, 0, 0);
+  members.erase(members.begin(), members.end());
+  parts.erase(parts.begin(), parts.end());
+  reportAs.erase(reportAs.begin(), reportAs.end());
+  meshes.erase(meshes.begin(), meshes.end());
+  ownFlags.erase(ownFlags.begin(), ownFlags.end());
+  pickBlocks.erase(pickBlocks.begin(), pickBlocks.end());
+  visibleBlocks.erase(visibleBlocks.begin(), visibleBlocks.end());
+  flags.erase(flags.begin(), flags.end());
+  localXforms.erase(localXforms.begin(), localXforms.end());
+  worldXforms.erase(worldXforms.begin(), worldXforms.end());
+  xforms.erase(xforms.begin(), xforms.end());
+  invXforms.erase(invXforms.begin(), invXforms.end());
+  centerX.erase(centerX.begin(), centerX.end());
+  centerY.erase(centerY.begin(), centerY.end());
+  centerZ.erase(centerZ.begin(), centerZ.end());
+  radius.erase(radius.begin(), radius.end());
+  valid = true;
+}
+
+bool
+ManipPartTable::isValid() const
+{
+  return (valid && (parts.size() > 0));
+}
+
+int
+ManipPartTable::getNumEntries() const
+{
+  return parts.size();
+}
+
+void
+ManipPartTable::setTransform(const GleemMat4f &xform)
+{
+  bool translationOnly = (rootXformValid &&
+			  xform.equalExceptTranslation(rootXform));
+  rootXform = xform;
+  rootXformValid = true;
+  int numEntries = parts.size();
+  for (int i = 0; i < numEntries; i++)
+    {
+      if ((flags[i] & HAS_LOCAL) != 0)
+	{
+	  if (translationOnly && ((flags[i] & LOCAL_DIRTY) == 0))
+	    GleemMat4f::multTranslation(xform, localXforms[i],
+					worldXforms[i]);
+	  else
+	    {
+	      GleemMat4f::mult(xform, localXforms[i], worldXforms[i]);
+	      // Only the translation can be updated incrementally, and
+	      // only if the relative transform is affine
+	      const float *bottom = localXforms[i][3];
+	      if ((bottom[0] == 0) && (bottom[1] == 0) && (bottom[2] == 0) &&
+		  (bottom[3] == 1))
+		flags[i] &= ~LOCAL_DIRTY;
+	    }
+	  parts[i]->setTransform(worldXforms[i]);
+	}
+      else
+	parts[i]->setTransform(xform);
+    }
+}
+
+void
+ManipPartTable::render() const
+{
+  int numEntries = parts.size();
+  for (int i = 0; i < numEntries; i++)
+    if ((flags[i] & VISIBLE) != 0)
+      parts[i]->render();
+}
+
+bool
+ManipPartTable::getBoundingSphere(BSphere &bsph) const
+{
+  bsph.makeEmpty();
+  bool found = false;
+  int numEntries = parts.size();
+  for (int i = 0; i < numEntries; i++)
+    {
+      if ((flags[i] & PICK_ROOT) == 0)
+	continue;
+      if (radius[i] < 0.0f)
+	return false;
+      bsph.extendBy(BSphere(GleemV3f(centerX[i], centerY[i], centerZ[i]),
+			    radius[i]));
+      found = true;
+    }
+  return found;
+}
+
+void
+ManipPartTable::intersectRay(const GleemV3f &rayStart,
+			     const GleemV3f &rayDirection,
+			     vector<HitPoint> &results)
+{
+  HitPoint hit;
+  hit.rayStart = rayStart;
+  hit.rayDirection = rayDirection;
+  float dirLenSq = rayDirection.lengthSquared();
+  int numEntries = parts.size();
+  for (int i = 0; i < numEntries; i++)
+    {
+      if ((flags[i] & (PICKABLE | PICK_ROOT)) != (PICKABLE | PICK_ROOT))
+	continue;
+      GLEEM_STATS_INC(partsVisited);
+      // Inline version of BSphere::hitByRay()
+      float r = radius[i];
+      if (r >= 0.0f)
+	{
+	  float dx = centerX[i] - rayStart[0];
+	  float dy = centerY[i] - rayStart[1];
+	  float dz = centerZ[i] - rayStart[2];
+	  float c = dx * dx + dy * dy + dz * dz - r * r;
+	  if (c > 0.0f)
+	    {
+	      float b = (dx * rayDirection[0] + dy * rayDirection[1] +
+			 dz * rayDirection[2]);
+	      if ((b < 0.0f) || (b * b < c * dirLenSq))
+		continue;
+	    }
+	}
+      const ManipPartMesh *mesh = meshes[i];
+      if ((mesh != NULL) && ((flags[i] & INVERTIBLE) != 0))
+	{
+	  hit.manipulator = parts[i]->getParent();
+	  hit.manipPart = reportAs[i];
+	  GleemV3f testStart, testDirection;
+	  invXforms[i].xformPt(rayStart, testStart);
+	  invXforms[i].xformDir(rayDirection, testDirection);
+#ifdef GLEEM_ENABLE_STATS
+	  int numTested =
+#endif
+	    mesh->intersectRay(testStart, testDirection,
+			       NULL, &xforms[i], hit, results);
+	  GLEEM_STATS_ADD(trianglesTested, numTested);
+	}
+      else
+	{
+	  // Custom part or singular transform
+	  int topIdx = results.size();
+	  parts[i]->intersectRay(rayStart, rayDirection, results);
+	  for (int j = topIdx; j < results.size(); j++)
+	    results[j].manipPart = reportAs[i];
+	}
+    }
+}
+
+bool
+ManipPartTable::intersectFrustum(const Frustum &frustum) const
+{
+  int numEntries = parts.size();
+  for (int i = 0; i < numEntries; i++)
+    {
+      if ((flags[i] & (PICKABLE | PICK_ROOT)) != (PICKABLE | PICK_ROOT))
+	continue;
+      if (radius[i] < 0.0f)
+	{
+	  if (parts[i]->intersectFrustum(frustum))
+	    return true;
+	}
+      else if (frustum.intersectsSphere(BSphere(GleemV3f(centerX[i],
+							  centerY[i],
+							  centerZ[i]),
+						radius[i])))
+	return true;
+    }
+  return false;
+}
+
+int
+ManipPartTable::addEntry(ManipPart *part, ManipPart *reportAs,
+			 const ManipPartMesh *mesh, int flags,
+			 const GleemMat4f *localXform)
+{
+  parts.push_back(part);
+  this->reportAs.push_back(reportAs);
+  meshes.push_back(mesh);
+  ownFlags.push_back((unsigned char) flags);
+  pickBlocks.push_back(0);
+  visibleBlocks.push_back(0);
+  this->flags.push_back((unsigned char) flags);
+  GleemMat4f ident;
+  ident.makeIdent();
+  xforms.push_back(ident);
+  invXforms.push_back(ident);
+  localXforms.push_back(ident);
+  worldXforms.push_back(ident);
+  setLocalTransform(parts.size() - 1, localXform);
+  centerX.push_back(0);
+  centerY.push_back(0);
+  centerZ.push_back(0);
+  // No bounds until setTransform() is called
+  radius.push_back(-1.0f);
+  return parts.size() - 1;
+}
+
+void
+ManipPartTable::addMember(ManipPart *part, int begin, int end)
+{
+  if (part->getTable() != NULL)
+    {
+      // Already in this or another table
+      valid = false;
+      return;
+    }
+  part->setTable(this, begin, end);
+  members.push_back(part);
+}
+
+void
+ManipPartTable::setFlag(int index, int flag, bool on)
+{
+  if (on)
+    ownFlags[index] |= flag;
+  else
+    ownFlags[index] &= ~flag;
+  updateFlags(index);
+}
+
+void
+ManipPartTable::blockFlag(int begin, int end, int flag, bool block)
+{
+  vector<unsigned short> &blocks =
+    ((flag == PICKABLE) ? pickBlocks : visibleBlocks);
+  for (int i = begin; i < end; i++)
+    {
+      if (block)
+	++blocks[i];
+      else
+	{
+	  assert(blocks[i] > 0);
+	  --blocks[i];
+	}
+      updateFlags(i);
+    }
+}
+
+void
+ManipPartTable::setLocalTransform(int index, const GleemMat4f *localXform)
+{
+  if (localXform != NULL)
+    {
+      localXforms[index] = *localXform;
+      flags[index] |= (HAS_LOCAL | LOCAL_DIRTY);
+    }
+  else
+    {
+      localXforms[index].makeIdent();
+      flags[index] &= ~HAS_LOCAL;
+    }
+}
+
+void
+ManipPartTable::setTransform(int index,
+			     const GleemMat4f &xform,
+			     const GleemMat4f *invXform,
+			     const BSphere &bounds)
+{
+  xforms[index] = xform;
+  if (invXform != NULL)
+    {
+      invXforms[index] = *invXform;
+      flags[index] |= INVERTIBLE;
+    }
+  else
+    flags[index] &= ~INVERTIBLE;
+  const GleemV3f &center = bounds.getCenter();
+  centerX[index] = center[0];
+  centerY[index] = center[1];
+  centerZ[index] = center[2];
+  radius[index] = bounds.getRadius();
+}
+
+void
+ManipPartTable::updateFlags(int index)
+{
+  int res = ownFlags[index];
+  if (pickBlocks[index] != 0)
+    res &= ~PICKABLE;
+  if (visibleBlocks[index] != 0)
+    res &= ~VISIBLE;
+  flags[index] = (unsigned char) (res |
+				  (flags[index] & ~(VISIBLE | PICKABLE)));
+}
+
+void
+ManipPartTable::addRoot(ManipPart *root, bool pick)
+{
+  if (root == NULL)
+    return;
+  int begin = parts.size();
+  root->addToTable(*this, root, NULL);
+  if (pick)
+    for (int i = begin; i < parts.size(); i++)
+      flags[i] |= PICK_ROOT;
+}
@@ -0,0 +1,180 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_MANIP_PART_TABLE_H
+#define _GLEEM_MANIP_PART_TABLE_H
+
+#include <vector.h>
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+#include <gleem/HitPoint.h>
+#include <gleem/BSphere.h>
+#include <gleem/Frustum.h>
+#include <gleem/Linalg.h>
+
+GLEEM_ENTER_NAMESPACE
+
+class ManipPart;
+class ManipPartMesh;
+
+/** A compiled, structure-of-arrays form of a manipulator's ManipPart
+    trees: one entry per leaf holding its flags (with those of its
+    ancestor groups folded in), its transform relative to its root
+    (the product of the offsets of the ManipPartTransforms above it),
+    its world transform and bounds and its mesh, each in a contiguous
+    array indexed by entry. Rendering, picking and transform
+    propagation each become one loop over the entries instead of a
+    walk over the trees with a virtual call and, for transforms, a
+    matrix multiply per node. The ManipParts remain the interface for
+    building and changing the geometry and keep their entries up to
+    date; changing the offset of a ManipPartTransform patches the
+    relative transforms of the entries below it.
+
+    Leaves without a mesh (custom ManipParts) get entries too; for
+    those the table calls their intersectRay() and intersectFrustum()
+    methods. A part can be registered in only one table. Destroying a
+    registered part, or adding or removing a child of a registered
+    group, empties the table, which must then be rebuilt. */
+
+GLEEM_INTERNAL class GLEEMDLL ManipPartTable
+{
+public:
+  ManipPartTable();
+  /** Unregisters all parts */
+  ~ManipPartTable();
+
+  /** Adds entries for all of the leaves below root, or for root
+      itself if it is a leaf. As in ManipPartGroup::intersectRay(),
+      their hits are reported as hits on root. If root or any part
+      below it is already registered in a table, this table becomes
+      invalid until the next clear(). */
+  void addPickRoot(ManipPart *root);
+
+  /** Adds entries for a tree which is rendered and transformed
+      through the table but not picked, such as decorations whose
+      intersectRay() is empty */
+  void addRenderRoot(ManipPart *root);
+
+  /** Removes all entries and unregisters their parts */
+  void clear();
+
+  /** True if the table has entries and all of its parts are
+      registered in it */
+  bool isValid() const;
+
+  int getNumEntries() const;
+
+  /** Same as calling setTransform() on each root with the given
+      transform. The products of the transform with the entries'
+      relative transforms are cached, and only their translations are
+      recomputed when only the transform's translation has changed. */
+  void setTransform(const GleemMat4f &xform);
+
+  /** Same as calling render() on each root in turn */
+  void render() const;
+
+  /** Same as the union of getBoundingSphere() on each pick root.
+      Returns false if there are none or any can not supply bounds. */
+  bool getBoundingSphere(BSphere &bsph) const;
+
+  /** Same as calling intersectRay() on each pick root in turn */
+  void intersectRay(const GleemV3f &rayStart,
+		    const GleemV3f &rayDirection,
+		    vector<HitPoint> &results);
+
+  /** Same as calling intersectFrustum() on each pick root and
+      returning true if any did */
+  bool intersectFrustum(const Frustum &frustum) const;
+
+  enum
+  {
+    VISIBLE = 1,
+    PICKABLE = 2
+  };
+
+GLEEM_INTERNAL public:
+  // Called by ManipParts to build and maintain their entries
+
+  /** Adds an entry for a leaf part with the given VISIBLE and
+      PICKABLE flags, returning its index. Parts with a NULL mesh are
+      picked through their virtual methods. localXform is the product
+      of the offsets above the part, or NULL if there are none. */
+  int addEntry(ManipPart *part, ManipPart *reportAs,
+	       const ManipPartMesh *mesh, int flags,
+	       const GleemMat4f *localXform);
+
+  /** Registers a part, which owns entries [begin, end) */
+  void addMember(ManipPart *part, int begin, int end);
+
+  /** Sets or clears the given flag of a part's entry */
+  void setFlag(int index, int flag, bool on);
+
+  /** Called by a group whose own flag was turned off (block true) or
+      back on (block false); the flag is in effect for an entry only
+      if neither the entry nor any of its ancestors has it off */
+  void blockFlag(int begin, int end, int flag, bool block);
+
+  /** Replace the product of the offsets above an entry's part; see
+      addEntry() */
+  void setLocalTransform(int index, const GleemMat4f *localXform);
+
+  /** Update the world transform and bounds of an entry. invXform is
+      the inverse of xform, or NULL if xform is singular. */
+  void setTransform(int index,
+		    const GleemMat4f &xform,
+		    const GleemMat4f *invXform,
+		    const BSphere &bounds);
+
+private:
+  enum
+  {
+    // Set if invXforms is valid
+    INVERTIBLE = 4,
+    // Set if the entry was added by addPickRoot()
+    PICK_ROOT = 8,
+    // Set if localXforms is not the identity
+    HAS_LOCAL = 16,
+    // Set if localXforms changed since worldXforms was computed
+    LOCAL_DIRTY = 32
+  };
+
+  void addRoot(ManipPart *root, bool pick);
+
+  /** Recompute the flags in effect for an entry */
+  void updateFlags(int index);
+
+  bool valid;
+  vector<ManipPart *> members;
+  /** Last transform handed to setTransform(), if rootXformValid */
+  GleemMat4f rootXform;
+  bool rootXformValid;
+
+  // Per-entry arrays
+  vector<ManipPart *> parts;
+  vector<ManipPart *> reportAs;
+  vector<const ManipPartMesh *> meshes;
+  /** Flags as set on the part itself */
+  vector<unsigned char> ownFlags;
+  /** Number of ancestors with PICKABLE and VISIBLE off */
+  vector<unsigned short> pickBlocks;
+  vector<unsigned short> visibleBlocks;
+  /** Flags in effect, plus the private ones */
+  vector<unsigned char> flags;
+  vector<GleemMat4f> localXforms;
+  /** rootXform times localXforms, for entries with HAS_LOCAL */
+  vector<GleemMat4f> worldXforms;
+  vector<GleemMat4f> xforms;
+  vector<GleemMat4f> invXforms;
+  vector<float> centerX;
+  vector<float> centerY;
+  vector<float> centerZ;
+  vector<float> radius;
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_MANIP_PART_TABLE_H
@@ -5,12 +5,16 @@
  */
 
 #include <gleem/ManipPartTransform.h>
+#include <gleem/ManipPartTable.h>
 
 GLEEM_USE_NAMESPACE
 
 ManipPartTransform::ManipPartTransform(Manip *parent) :
   ManipPartGroup(parent)
 {
+  hasTableXform = false;
+  offsetTransform.makeIdent();
+  xformDirty = true;
 }
 
 ManipPartTransform::~ManipPartTransform()
@@ -20,16 +24,54 @@ ManipPartTransform::~ManipPartTransform()
 void
 ManipPartTransform::setTransform(const GleemMat4f &xform)
 {
-  GleemMat4f totalXform;
-  GleemMat4f::mult(xform, offsetTransform, totalXform);
+  if (!xformDirty && xform.equalExceptTranslation(parentXform))
+    GleemMat4f::multTranslation(xform, offsetTransform, totalXform);
+  else
+    {
+      GleemMat4f::mult(xform, offsetTransform, totalXform);
+      // The incremental update above is only valid for affine offsets
+      xformDirty = ((offsetTransform[3][0] != 0) ||
+		    (offsetTransform[3][1] != 0) ||
+		    (offsetTransform[3][2] != 0) ||
+		    (offsetTransform[3][3] != 1));
+    }
+  parentXform = xform;
   for (int i = 0; i < getNumParts(); i++)
     getPart(i)->setTransform(totalXform);
 }
 
+void
+ManipPartTransform::addToTable(ManipPartTable &table, ManipPart *reportAs,
+			       const GleemMat4f *localXform)
+{
+  hasTableXform = (localXform != NULL);
+  if (hasTableXform)
+    {
+      tableXform = *localXform;
+      GleemMat4f totalXform;
+      GleemMat4f::mult(tableXform, offsetTransform, totalXform);
+      ManipPartGroup::addToTable(table, reportAs, &totalXform);
+    }
+  else
+    ManipPartGroup::addToTable(table, reportAs, &offsetTransform);
+}
+
+void
+ManipPartTransform::setTableLocalTransform(const GleemMat4f *localXform)
+{
+  hasTableXform = (localXform != NULL);
+  if (hasTableXform)
+    tableXform = *localXform;
+  updateTableLocalTransform();
+}
+
 void
 ManipPartTransform::setOffsetTransform(const GleemMat4f &offsetTransform)
 {
   this->offsetTransform = offsetTransform;
+  xformDirty = true;
+  if (getTable() != NULL)
+    updateTableLocalTransform();
 }
 
 const GleemMat4f &
@@ -37,3 +79,16 @@ ManipPartTransform::getOffsetTransform() const
 {
   return offsetTransform;
 }
+
+void
+ManipPartTransform::updateTableLocalTransform()
+{
+  if (hasTableXform)
+    {
+      GleemMat4f totalXform;
+      GleemMat4f::mult(tableXform, offsetTransform, totalXform);
+      ManipPartGroup::setTableLocalTransform(&totalXform);
+    }
+  else
+    ManipPartGroup::setTableLocalTransform(&offsetTransform);
+}
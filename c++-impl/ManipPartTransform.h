@@ -15,7 +15,9 @@
 GLEEM_ENTER_NAMESPACE
 
 /** A Group which contains an offset transformation which is performed
-    before the one handed down in setTransform. */
+    before the one handed down in setTransform. The product of the two
+    is cached; when only the translation of the transform handed down
+    changes, only the translation of the product is recomputed. */
 
 GLEEM_INTERNAL class GLEEMDLL ManipPartTransform : public ManipPartGroup
 {
@@ -25,14 +27,34 @@ public:
 
   /** Inherit everything but setTransform from ManipPartGroup */
   virtual void setTransform(const GleemMat4f &xform);
+  /** Folds the offset transformation into the children's entries */
+  virtual void addToTable(ManipPartTable &table, ManipPart *reportAs,
+			  const GleemMat4f *localXform);
+  virtual void setTableLocalTransform(const GleemMat4f *localXform);
 
   // Transform-specific functions
 
+  /** If this part is registered in a ManipPartTable, patches the
+      entries below it. As before, the new offset takes effect at the
+      next setTransform(). */
   void setOffsetTransform(const GleemMat4f &offsetTransform);
   const GleemMat4f &getOffsetTransform() const;
 
 private:
+  /** Hands the product of tableXform and the offset to the children */
+  void updateTableLocalTransform();
+
   GleemMat4f offsetTransform;
+  /** Last transform handed down and its product with the offset */
+  GleemMat4f parentXform;
+  GleemMat4f totalXform;
+  /** True if totalXform must be recomputed in full, because there
+      has been no setTransform() since the offset was set or the
+      offset is not affine */
+  bool xformDirty;
+  /** The localXform this part was registered with, if any */
+  GleemMat4f tableXform;
+  bool hasTableXform;
 };
 
 GLEEM_EXIT_NAMESPACE
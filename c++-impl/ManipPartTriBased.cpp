@@ -10,27 +10,26 @@
 #endif
 #include <GL/gl.h>
 #include <gleem/ManipPartTriBased.h>
-#include <gleem/RayTriangleIntersection.h>
+#include <gleem/ManipPartTable.h>
+#include <gleem/ManipStats.h>
+#include <gleem/Trace.h>
 
 GLEEM_USE_NAMESPACE
 
 ManipPartTriBased::ManipPartTriBased(Manip *parent) :
   ManipPart(parent)
 {
-  vertices = NULL;
-  numVertices = 0;
-  normals = NULL;
-  numNormals = 0;
-  vertexIndices = NULL;
-  numVertexIndices = 0;
-  normalIndices = NULL;
-  numNormalIndices = 0;
   color.setValue(0.8f, 0.8f, 0.8f);
   highlightColor.setValue(0.8f, 0.8f, 0);
   highlighted = false;
   visible = true;
   pickable = true;
   xform.makeIdent();
+  invXform.makeIdent();
+  invXformValid = true;
+  normalXform.makeIdent();
+  xformDirty = true;
+  numTranslations = 0;
 }
 
 ManipPartTriBased::~ManipPartTriBased()
@@ -58,10 +57,10 @@ ManipPartTriBased::setHighlightColor(const GleemV3f &highlightColor)
 void
 ManipPartTriBased::render() const
 {
-  assert(numVertexIndices == numNormalIndices);
-  assert((numVertexIndices % 4) == 0);
-  assert(numVertices == curVertices.size());
-  assert(numNormals == curNormals.size());
+  assert(mesh.numVertexIndices == mesh.numNormalIndices);
+  assert((mesh.numVertexIndices % 4) == 0);
+  assert(mesh.numVertices == curVertices.size());
+  assert(mesh.numNormals == curNormals.size());
   if (!visible)
     return;
   bool lightingOn = true;
@@ -82,22 +81,22 @@ ManipPartTriBased::render() const
   else
     glColor3f(color[0], color[1], color[2]);
   int i = 0;
-  while (i < numVertexIndices)
+  while (i < mesh.numVertexIndices)
     {
-      const GleemV3f &n0 = tmpNormals[normalIndices[i]];
-      const GleemV3f &v0 = tmpVertices[vertexIndices[i]];
+      const GleemV3f &n0 = tmpNormals[mesh.normalIndices[i]];
+      const GleemV3f &v0 = tmpVertices[mesh.vertexIndices[i]];
       glNormal3f(n0[0], n0[1], n0[2]);
       glVertex3f(v0[0], v0[1], v0[2]);
       i++;
 
-      const GleemV3f &n1 = tmpNormals[normalIndices[i]];
-      const GleemV3f &v1 = tmpVertices[vertexIndices[i]];
+      const GleemV3f &n1 = tmpNormals[mesh.normalIndices[i]];
+      const GleemV3f &v1 = tmpVertices[mesh.vertexIndices[i]];
       glNormal3f(n1[0], n1[1], n1[2]);
       glVertex3f(v1[0], v1[1], v1[2]);
       i++;
 
-      const GleemV3f &n2 = tmpNormals[normalIndices[i]];
-      const GleemV3f &v2 = tmpVertices[vertexIndices[i]];
+      const GleemV3f &n2 = tmpNormals[mesh.normalIndices[i]];
+      const GleemV3f &v2 = tmpVertices[mesh.vertexIndices[i]];
       glNormal3f(n2[0], n2[1], n2[2]);
       glVertex3f(v2[0], v2[1], v2[2]);
       i+=2;
@@ -116,59 +115,75 @@ ManipPartTriBased::intersectRay(const GleemV3f &rayStart,
 				const GleemV3f &rayDirection,
 				vector<HitPoint> &results)
 {
-  assert(numVertexIndices == numNormalIndices);
-  assert((numVertexIndices % 4) == 0);
-  assert(numVertices == curVertices.size());
-  assert(numNormals == curNormals.size());
+  GLEEM_STATS_INC(partsVisited);
+  assert(mesh.numVertexIndices == mesh.numNormalIndices);
+  assert((mesh.numVertexIndices % 4) == 0);
+  assert(mesh.numVertices == curVertices.size());
+  assert(mesh.numNormals == curNormals.size());
   if (!pickable)
     return;
-  GleemV3f intPt;
-  float t;
+  // Intersect in local space if possible, transforming the ray once
+  // rather than relying on the transformed vertices. The direction is
+  // not renormalized, so t is the same in both spaces.
   HitPoint hitPt;
   hitPt.manipulator = getParent();
   hitPt.manipPart = this;
-  assert(hitPt.manipPart != NULL);
-  for (int i = 0; i < numVertexIndices; i+=4)
+  hitPt.rayStart = rayStart;
+  hitPt.rayDirection = rayDirection;
+  GleemV3f testStart = rayStart;
+  GleemV3f testDirection = rayDirection;
+  const GleemV3f *vertices = NULL;
+  const GleemMat4f *toWorld = &xform;
+  if (invXformValid)
     {
-      int i0 = vertexIndices[i];
-      int i1 = vertexIndices[i+1];
-      int i2 = vertexIndices[i+2];
-      int i3 = vertexIndices[i+3];
-      assert(i3 == -1);
-      if (RayTriangleIntersection::intersectRayWithTriangle(rayStart,
-							    rayDirection,
-							    curVertices[i0],
-							    curVertices[i1],
-							    curVertices[i2],
-							    intPt,
-							    t)
-	  == RayTriangleIntersection::RTI_INTERSECTION)
-	{
-	  // Check for intersections behind the ray
-	  if (t >= 0)
-	    {
-	      hitPt.rayStart = rayStart;
-	      hitPt.rayDirection = rayDirection;
-	      hitPt.intPt = intPt;
-	      hitPt.t = t;
-	      /*
-	      cerr << "ManipPartTriBased::intersectRay:" << endl;
-	      cerr << "hitPt.manipulator = "
-		   << (void *) hitPt.manipulator << endl;
-	      cerr << "hitPt.manipPart = "
-		   << (void *) hitPt.manipPart << endl;
-	      */
-	      results.push_back(hitPt);
-	    }
-	}
+      invXform.xformPt(rayStart, testStart);
+      invXform.xformDir(rayDirection, testDirection);
     }
+  else
+    {
+      vertices = (GleemV3f *) curVertices.begin();
+      toWorld = NULL;
+    }
+#ifdef GLEEM_ENABLE_STATS
+  int numTested =
+#endif
+    mesh.intersectRay(testStart, testDirection, vertices, toWorld,
+		      hitPt, results);
+  GLEEM_STATS_ADD(trianglesTested, numTested);
 }
 
 void
 ManipPartTriBased::setTransform(const GleemMat4f &xform)
 {
-  this->xform = xform;
-  recalcVertices();
+  if (!xformDirty && (numTranslations < MAX_TRANSLATIONS) &&
+      xform.equalExceptTranslation(this->xform))
+    {
+      // Only the translation changed, which leaves the normals alone
+      // and moves the transformed vertices and bounds rigidly
+      GleemV3f delta(xform[0][3] - this->xform[0][3],
+		     xform[1][3] - this->xform[1][3],
+		     xform[2][3] - this->xform[2][3]);
+      if ((delta[0] == 0) && (delta[1] == 0) && (delta[2] == 0))
+	return;
+      this->xform = xform;
+      if (invXformValid)
+	GleemMat4f::invertAffineTranslation(xform, invXform);
+      translateVertices(delta);
+    }
+  else
+    {
+      this->xform = xform;
+      invXform = xform;
+      invXformValid = invXform.invertAffine();
+      if (!xform.getNormalMatrix(normalXform))
+	normalXform = xform;
+      recalcVertices();
+      xformDirty = false;
+      numTranslations = 0;
+    }
+  if (getTable() != NULL)
+    getTable()->setTransform(getTableBegin(), xform,
+			     (invXformValid ? &invXform : NULL), bounds);
 }
 
 void
@@ -186,6 +201,8 @@ ManipPartTriBased::clearHighlight()
 void
 ManipPartTriBased::setPickable(bool pickable)
 {
+  if (getTable() != NULL)
+    getTable()->setFlag(getTableBegin(), ManipPartTable::PICKABLE, pickable);
   this->pickable = pickable;
 }
 
@@ -198,6 +215,8 @@ ManipPartTriBased::getPickable() const
 void
 ManipPartTriBased::setVisible(bool visible)
 {
+  if (getTable() != NULL)
+    getTable()->setFlag(getTableBegin(), ManipPartTable::VISIBLE, visible);
   this->visible = visible;
 }
 
@@ -208,100 +227,158 @@ ManipPartTriBased::getVisible() const
 }
 
 void
-ManipPartTriBased::setVertices(GleemV3f *vertices, int numVertices)
+ManipPartTriBased::setVertices(const GleemV3f *vertices, int numVertices)
 {
-  this->vertices = vertices;
-  this->numVertices = numVertices;
+  mesh.vertices = vertices;
+  mesh.numVertices = numVertices;
+  xformDirty = true;
 }
 
-GleemV3f *
+const GleemV3f *
 ManipPartTriBased::getVertices() const
 {
-  return vertices;
+  return mesh.vertices;
 }
 
 int
 ManipPartTriBased::getNumVertices() const
 {
-  return numVertices;
+  return mesh.numVertices;
 }
 
 void
-ManipPartTriBased::setNormals(GleemV3f *normals, int numNormals)
+ManipPartTriBased::setNormals(const GleemV3f *normals, int numNormals)
+{
+  mesh.normals = normals;
+  mesh.numNormals = numNormals;
+  xformDirty = true;
+}
+
+const GleemV3f *
+ManipPartTriBased::getNormals() const
 {
-  this->normals = normals;
-  this->numNormals = numNormals;
+  return mesh.normals;
 }
 
 int
 ManipPartTriBased::getNumNormals() const
 {
-  return numNormals;
+  return mesh.numNormals;
 }
 
 void
-ManipPartTriBased::setVertexIndices(int *vertexIndices, int numVertexIndices)
+ManipPartTriBased::setVertexIndices(const int *vertexIndices,
+				    int numVertexIndices)
 {
-  this->vertexIndices = vertexIndices;
-  this->numVertexIndices = numVertexIndices;
+  mesh.vertexIndices = vertexIndices;
+  mesh.numVertexIndices = numVertexIndices;
 }
 
-int *
+const int *
 ManipPartTriBased::getVertexIndices() const
 {
-  return vertexIndices;
+  return mesh.vertexIndices;
 }
 
 int
 ManipPartTriBased::getNumVertexIndices() const
 {
-  return numVertexIndices;
+  return mesh.numVertexIndices;
 
 }
 
 void
-ManipPartTriBased::setNormalIndices(int *normalIndices, int numNormalIndices)
+ManipPartTriBased::setNormalIndices(const int *normalIndices,
+				    int numNormalIndices)
 {
-  this->normalIndices = normalIndices;
-  this->numNormalIndices = numNormalIndices;
+  mesh.normalIndices = normalIndices;
+  mesh.numNormalIndices = numNormalIndices;
 }
 
-int *
+const int *
 ManipPartTriBased::getNormalIndices() const
 {
-  return normalIndices;
+  return mesh.normalIndices;
 }
 
 int
 ManipPartTriBased::getNumNormalIndices() const
 {
-  return numNormalIndices;
+  return mesh.numNormalIndices;
 
 }
 
+void
+ManipPartTriBased::setEdges(const GleemV3f *edges)
+{
+  mesh.edges = edges;
+}
+
+const GleemV3f *
+ManipPartTriBased::getEdges() const
+{
+  return mesh.edges;
+}
+
+void
+ManipPartTriBased::addToTable(ManipPartTable &table, ManipPart *reportAs,
+			      const GleemMat4f *localXform)
+{
+  int index = table.addEntry(this, reportAs, &mesh,
+			     (visible ? ManipPartTable::VISIBLE : 0) |
+			     (pickable ? ManipPartTable::PICKABLE : 0),
+			     localXform);
+  table.setTransform(index, xform, (invXformValid ? &invXform : NULL),
+		     bounds);
+  table.addMember(this, index, index + 1);
+}
+
+bool
+ManipPartTriBased::getBoundingSphere(BSphere &bsph) const
+{
+  bsph = bounds;
+  return true;
+}
+
 void
 ManipPartTriBased::recalcVertices()
 {
+  GLEEM_TRACE_SCOPE("ManipPartTriBased::recalcVertices", this);
   curVertices.erase(curVertices.begin(), curVertices.end());
   curNormals.erase(curNormals.begin(), curNormals.end());
+  // Grow each vector once, not by doubling, the first time through
+  curVertices.reserve(mesh.numVertices);
+  curNormals.reserve(mesh.numNormals);
   GleemV3f v, n;
   GleemV3f vNew, nNew;
   int i;
-  for (i = 0; i < numVertices; i++)
+  for (i = 0; i < mesh.numVertices; i++)
     {
-      v = vertices[i];
+      v = mesh.vertices[i];
       xform.xformPt(v, vNew);
       curVertices.push_back(vNew);
     }
-  for (i = 0; i < numNormals; i++)
+  for (i = 0; i < mesh.numNormals; i++)
     {
-      n = normals[i];
-      xform.xformDir(n, nNew);
+      n = mesh.normals[i];
+      normalXform.xformDir(n, nNew);
       nNew.normalize();
       curNormals.push_back(nNew);
     }
-  assert(numVertexIndices == numNormalIndices);
-  assert((numVertexIndices % 4) == 0);
-  assert(numVertices == curVertices.size());
-  assert(numNormals == curNormals.size());
+  assert(mesh.numVertexIndices == mesh.numNormalIndices);
+  assert((mesh.numVertexIndices % 4) == 0);
+  assert(mesh.numVertices == curVertices.size());
+  assert(mesh.numNormals == curNormals.size());
+  bounds.makeFromPoints((GleemV3f *) curVertices.begin(), mesh.numVertices);
+}
+
+void
+ManipPartTriBased::translateVertices(const GleemV3f &delta)
+{
+  GLEEM_TRACE_SCOPE("ManipPartTriBased::translateVertices", this);
+  int numVertices = curVertices.size();
+  for (int i = 0; i < numVertices; i++)
+    curVertices[i] += delta;
+  bounds.setCenter(bounds.getCenter() + delta);
+  ++numTranslations;
 }
@@ -12,6 +12,7 @@
 #include <gleem/GleemDLL.h>
 #include <gleem/Util.h>
 #include <gleem/Manip.h>
+#include <gleem/ManipPartMesh.h>
 #include <gleem/Linalg.h>
 
 GLEEM_ENTER_NAMESPACE
@@ -49,33 +50,57 @@ public:
   /** Default is visible */
   virtual void setVisible(bool visible);
   virtual bool getVisible() const;
+  virtual bool getBoundingSphere(BSphere &bsph) const;
+
+GLEEM_INTERNAL public:
+  /** Adds one entry with this part's mesh */
+  virtual void addToTable(ManipPartTable &table, ManipPart *reportAs,
+			  const GleemMat4f *localXform);
 
 protected:
   /** Caller retains ownership of memory. */
-  void setVertices(GleemV3f *vertices, int numVertices);
-  GleemV3f *getVertices() const;
+  void setVertices(const GleemV3f *vertices, int numVertices);
+  const GleemV3f *getVertices() const;
   int getNumVertices() const;
   
   /** Normals are specified per-vertex. Caller retains ownership of
       memory. */
-  void setNormals(GleemV3f *normals, int numNormals);
-  GleemV3f *getNormals() const;
+  void setNormals(const GleemV3f *normals, int numNormals);
+  const GleemV3f *getNormals() const;
   int getNumNormals() const;
 
   /** Creates triangles out of vertex and normal lists. -1 indicates
       end of triangle. Caller retains ownership of memory. */
-  void setVertexIndices(int *vertexIndices, int numVertexIndices);
-  int *getVertexIndices() const;
+  void setVertexIndices(const int *vertexIndices, int numVertexIndices);
+  const int *getVertexIndices() const;
   int getNumVertexIndices() const;
 
   /** Creates triangles out of vertex and normal lists. -1 indicates
       end of triangle. Caller retains ownership of memory. */
-  void setNormalIndices(int *normalIndices, int numNormalIndices);
-  int *getNormalIndices() const;
+  void setNormalIndices(const int *normalIndices, int numNormalIndices);
+  const int *getNormalIndices() const;
   int getNumNormalIndices() const;
 
+  /** Optional precomputed edges of the untransformed triangles, two
+      per triangle: v1 - v0 and v2 - v0 for vertex indices v0, v1 and
+      v2. If these are not supplied (the default) they are computed
+      as needed during ray intersection. Caller retains ownership of
+      memory. */
+  void setEdges(const GleemV3f *edges);
+  const GleemV3f *getEdges() const;
+
 private:
+  enum
+  {
+    /** Translation-only updates made incrementally before the
+        transformed vertices are recomputed from scratch, which
+        bounds the accumulated rounding error */
+    MAX_TRANSLATIONS = 64
+  };
+
   void recalcVertices();
+  /** Move the transformed vertices and bounds by delta */
+  void translateVertices(const GleemV3f &delta);
 
   GleemV3f color;
   GleemV3f highlightColor;
@@ -83,18 +108,25 @@ private:
   bool pickable;
   bool visible;
   /** Pointers down to subclass-specific data */
-  GleemV3f *vertices;
-  int numVertices;
-  GleemV3f *normals;
-  int numNormals;
-  int *vertexIndices;
-  int numVertexIndices;
-  int *normalIndices;
-  int numNormalIndices;
+  ManipPartMesh mesh;
   /** Current transformation matrix */
   GleemMat4f xform;
+  /** Inverse of xform, used to intersect rays in local space. Only
+      valid if invXformValid is true; xform may contain a zero
+      scale. */
+  GleemMat4f invXform;
+  bool invXformValid;
+  /** Inverse transpose of xform, for the normals */
+  GleemMat4f normalXform;
+  /** True if the next setTransform() must recompute everything from
+      scratch, because there has been none yet or the mesh changed */
+  bool xformDirty;
+  /** Translation-only updates since the last full recomputation */
+  int numTranslations;
   /** Transformed vertices */
   vector<GleemV3f> curVertices;
+  /** Bounds of the transformed vertices */
+  BSphere bounds;
   /** Transformed normals */
   vector<GleemV3f> curNormals;
 };
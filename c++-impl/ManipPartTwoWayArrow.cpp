@@ -5,40 +5,41 @@
  */
 
 #include <gleem/ManipPartTwoWayArrow.h>
-#include <gleem/NormalCalc.h>
 
 GLEEM_USE_NAMESPACE
 
-float
-ManipPartTwoWayArrow::verticesAsFloats[][3] = {
+// Normals (one per triangle, counterclockwise) and edges are derived
+// from the vertex and index tables; see ManipPartCube.cpp.
+
+const float
+ManipPartTwoWayArrow::verticesAsFloats[][GLEEM_V3F_STRIDE] = {
   // Left tetrahedron
-  {-1, 0, 0},
-  {-0.666666, 0.166666, 0.166666},
-  {-0.666666, -0.166666, 0.166666},
-  {-0.666666, -0.166666, -0.166666},
-  {-0.666666, 0.166666, -0.166666},
+  GLEEM_V3F_INIT(-1, 0, 0),
+  GLEEM_V3F_INIT(-0.666666, 0.166666, 0.166666),
+  GLEEM_V3F_INIT(-0.666666, -0.166666, 0.166666),
+  GLEEM_V3F_INIT(-0.666666, -0.166666, -0.166666),
+  GLEEM_V3F_INIT(-0.666666, 0.166666, -0.166666),
 
   // Box at center
-  {-0.666666, 0.041666, 0.0416666},
-  {-0.666666, -0.041666, 0.0416666},
-  {-0.666666, -0.041666, -0.0416666},
-  {-0.666666, 0.041666, -0.0416666},
-  {0.666666, 0.041666, 0.0416666},
-  {0.666666, -0.041666, 0.0416666},
-  {0.666666, -0.041666, -0.0416666},
-  {0.666666, 0.041666, -0.0416666},
+  GLEEM_V3F_INIT(-0.666666, 0.041666, 0.0416666),
+  GLEEM_V3F_INIT(-0.666666, -0.041666, 0.0416666),
+  GLEEM_V3F_INIT(-0.666666, -0.041666, -0.0416666),
+  GLEEM_V3F_INIT(-0.666666, 0.041666, -0.0416666),
+  GLEEM_V3F_INIT(0.666666, 0.041666, 0.0416666),
+  GLEEM_V3F_INIT(0.666666, -0.041666, 0.0416666),
+  GLEEM_V3F_INIT(0.666666, -0.041666, -0.0416666),
+  GLEEM_V3F_INIT(0.666666, 0.041666, -0.0416666),
 
   // Right tetrahedron
-  {0.666666, 0.166666, 0.166666},
-  {0.666666, 0.166666, -0.166666},
-  {0.666666, -0.166666, -0.166666},
-  {0.666666, -0.166666, 0.166666},
-  {1, 0, 0}
+  GLEEM_V3F_INIT(0.666666, 0.166666, 0.166666),
+  GLEEM_V3F_INIT(0.666666, 0.166666, -0.166666),
+  GLEEM_V3F_INIT(0.666666, -0.166666, -0.166666),
+  GLEEM_V3F_INIT(0.666666, -0.166666, 0.166666),
+  GLEEM_V3F_INIT(1, 0, 0)
 };
-GleemV3f *ManipPartTwoWayArrow::vertices = NULL;
-int ManipPartTwoWayArrow::numVertices = 18;
+const int ManipPartTwoWayArrow::numVertices = 18;
 
-int
+const int
 ManipPartTwoWayArrow::vertexIndices[] = {
   // Left tetrahedron
   1, 0, 2, -1,
@@ -70,42 +71,126 @@ ManipPartTwoWayArrow::vertexIndices[] = {
   17, 16, 15, -1,
   17, 13, 16, -1
 };
-int ManipPartTwoWayArrow::numVertexIndices = 96;
+const int ManipPartTwoWayArrow::numVertexIndices = 96;
+
+const float
+ManipPartTwoWayArrow::normalsAsFloats[][GLEEM_V3F_STRIDE] = {
+  GLEEM_V3F_INIT(-0.447211415f, 0, 0.894428253f),
+  GLEEM_V3F_INIT(-0.447211415f, -0.894428253f, 0),
+  GLEEM_V3F_INIT(-0.447211415f, 0, -0.894428253f),
+  GLEEM_V3F_INIT(-0.447211415f, 0.894428253f, 0),
+  GLEEM_V3F_INIT(1, 0, 0),
+  GLEEM_V3F_INIT(1, 0, 0),
+  GLEEM_V3F_INIT(-1, 0, 0),
+  GLEEM_V3F_INIT(-1, 0, 0),
+  GLEEM_V3F_INIT(0, 0, 1),
+  GLEEM_V3F_INIT(0, 0, 1),
+  GLEEM_V3F_INIT(0, -1, 0),
+  GLEEM_V3F_INIT(0, -1, 0),
+  GLEEM_V3F_INIT(0, 0, -1),
+  GLEEM_V3F_INIT(0, 0, -1),
+  GLEEM_V3F_INIT(0, 1, 0),
+  GLEEM_V3F_INIT(0, 1, 0),
+  GLEEM_V3F_INIT(1, 0, 0),
+  GLEEM_V3F_INIT(1, 0, 0),
+  GLEEM_V3F_INIT(-1, 0, 0),
+  GLEEM_V3F_INIT(-1, 0, 0),
+  GLEEM_V3F_INIT(0.447211415f, 0.894428253f, 0),
+  GLEEM_V3F_INIT(0.447211415f, 0, -0.894428253f),
+  GLEEM_V3F_INIT(0.447211415f, -0.894428253f, 0),
+  GLEEM_V3F_INIT(0.447211415f, 0, 0.894428253f)
+};
+const int ManipPartTwoWayArrow::numNormals = 24;
 
-GleemV3f *
-ManipPartTwoWayArrow::normals = NULL;
-int ManipPartTwoWayArrow::numNormals = 0;
+const int
+ManipPartTwoWayArrow::normalIndices[] = {
+  0, 0, 0, -1,
+  1, 1, 1, -1,
+  2, 2, 2, -1,
+  3, 3, 3, -1,
+  4, 4, 4, -1,
+  5, 5, 5, -1,
+  6, 6, 6, -1,
+  7, 7, 7, -1,
+  8, 8, 8, -1,
+  9, 9, 9, -1,
+  10, 10, 10, -1,
+  11, 11, 11, -1,
+  12, 12, 12, -1,
+  13, 13, 13, -1,
+  14, 14, 14, -1,
+  15, 15, 15, -1,
+  16, 16, 16, -1,
+  17, 17, 17, -1,
+  18, 18, 18, -1,
+  19, 19, 19, -1,
+  20, 20, 20, -1,
+  21, 21, 21, -1,
+  22, 22, 22, -1,
+  23, 23, 23, -1
+};
+const int ManipPartTwoWayArrow::numNormalIndices = 96;
 
-int *ManipPartTwoWayArrow::normalIndices = NULL;
-int ManipPartTwoWayArrow::numNormalIndices = 0;
+const float
+ManipPartTwoWayArrow::edgesAsFloats[][GLEEM_V3F_STRIDE] = {
+  GLEEM_V3F_INIT(-0.333334029f, -0.166666001f, -0.166666001f),
+  GLEEM_V3F_INIT(0, -0.333332002f, 0),
+  GLEEM_V3F_INIT(-0.333334029f, 0.166666001f, -0.166666001f),
+  GLEEM_V3F_INIT(0, 0, -0.333332002f),
+  GLEEM_V3F_INIT(-0.333334029f, 0.166666001f, 0.166666001f),
+  GLEEM_V3F_INIT(0, 0.333332002f, 0),
+  GLEEM_V3F_INIT(-0.333334029f, -0.166666001f, 0.166666001f),
+  GLEEM_V3F_INIT(0, 0, 0.333332002f),
+  GLEEM_V3F_INIT(0, -0.333332002f, 0),
+  GLEEM_V3F_INIT(0, -0.333332002f, -0.333332002f),
+  GLEEM_V3F_INIT(0, -0.333332002f, -0.333332002f),
+  GLEEM_V3F_INIT(0, 0, -0.333332002f),
+  GLEEM_V3F_INIT(0, -0.0833320022f, -0.0833332017f),
+  GLEEM_V3F_INIT(0, -0.0833320022f, 0),
+  GLEEM_V3F_INIT(0, 0, -0.0833332017f),
+  GLEEM_V3F_INIT(0, -0.0833320022f, -0.0833332017f),
+  GLEEM_V3F_INIT(0, -0.0833320022f, 0),
+  GLEEM_V3F_INIT(1.33333194f, -0.0833320022f, 0),
+  GLEEM_V3F_INIT(1.33333194f, -0.0833320022f, 0),
+  GLEEM_V3F_INIT(1.33333194f, 0, 0),
+  GLEEM_V3F_INIT(0, 0, -0.0833332017f),
+  GLEEM_V3F_INIT(1.33333194f, 0, -0.0833332017f),
+  GLEEM_V3F_INIT(1.33333194f, 0, -0.0833332017f),
+  GLEEM_V3F_INIT(1.33333194f, 0, 0),
+  GLEEM_V3F_INIT(0, 0.0833320022f, 0),
+  GLEEM_V3F_INIT(1.33333194f, 0.0833320022f, 0),
+  GLEEM_V3F_INIT(1.33333194f, 0.0833320022f, 0),
+  GLEEM_V3F_INIT(1.33333194f, 0, 0),
+  GLEEM_V3F_INIT(0, 0, 0.0833332017f),
+  GLEEM_V3F_INIT(1.33333194f, 0, 0.0833332017f),
+  GLEEM_V3F_INIT(1.33333194f, 0, 0.0833332017f),
+  GLEEM_V3F_INIT(1.33333194f, 0, 0),
+  GLEEM_V3F_INIT(0, -0.0833320022f, 0),
+  GLEEM_V3F_INIT(0, -0.0833320022f, -0.0833332017f),
+  GLEEM_V3F_INIT(0, -0.0833320022f, -0.0833332017f),
+  GLEEM_V3F_INIT(0, 0, -0.0833332017f),
+  GLEEM_V3F_INIT(0, 0, -0.333332002f),
+  GLEEM_V3F_INIT(0, -0.333332002f, -0.333332002f),
+  GLEEM_V3F_INIT(0, -0.333332002f, -0.333332002f),
+  GLEEM_V3F_INIT(0, -0.333332002f, 0),
+  GLEEM_V3F_INIT(-0.333334029f, 0.166666001f, -0.166666001f),
+  GLEEM_V3F_INIT(-0.333334029f, 0.166666001f, 0.166666001f),
+  GLEEM_V3F_INIT(-0.333334029f, -0.166666001f, -0.166666001f),
+  GLEEM_V3F_INIT(-0.333334029f, 0.166666001f, -0.166666001f),
+  GLEEM_V3F_INIT(-0.333334029f, -0.166666001f, 0.166666001f),
+  GLEEM_V3F_INIT(-0.333334029f, -0.166666001f, -0.166666001f),
+  GLEEM_V3F_INIT(-0.333334029f, 0.166666001f, 0.166666001f),
+  GLEEM_V3F_INIT(-0.333334029f, -0.166666001f, 0.166666001f)
+};
 
 ManipPartTwoWayArrow::ManipPartTwoWayArrow(Manip *parent) :
   ManipPartTriBased(parent)
 {
-  // FIXME: not thread safe
-  if (vertices == NULL)
-    {
-      vertices = new GleemV3f[numVertices];
-      for (int i = 0; i < numVertices; i++)
-	vertices[i].setValue(verticesAsFloats[i][0],
-			     verticesAsFloats[i][1],
-			     verticesAsFloats[i][2]);
-
-      bool result = NormalCalc::computeFacetedNormals(vertices,
-						      numVertices,
-						      vertexIndices,
-						      numVertexIndices,
-						      true,
-						      normals,
-						      numNormals,
-						      normalIndices,
-						      numNormalIndices);
-      assert(result == true);
-    }
-  setVertices(vertices, numVertices);
+  setVertices((const GleemV3f *) verticesAsFloats, numVertices);
   setVertexIndices(vertexIndices, numVertexIndices);
-  setNormals(normals, numNormals);
+  setNormals((const GleemV3f *) normalsAsFloats, numNormals);
   setNormalIndices(normalIndices, numNormalIndices);
+  setEdges((const GleemV3f *) edgesAsFloats);
 }
 
 ManipPartTwoWayArrow::~ManipPartTwoWayArrow()
@@ -0,0 +1,32 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <gleem/ManipState.h>
+
+GLEEM_USE_NAMESPACE
+
+ManipState::ManipState()
+{
+  translation.setValue(0, 0, 0);
+  scale.setValue(1, 1, 1);
+}
+
+void
+ManipState::getMatrix(GleemMat4f &mat) const
+{
+  // The rotation's columns scaled, then the translation in the
+  // rightmost column; the same as multiplying out the three matrices
+  GleemMat4f rotMat;
+  rotMat.makeIdent();
+  rotMat.setRotation(rotation);
+  mat.makeIdent();
+  for (int i = 0; i < 3; i++)
+    {
+      for (int j = 0; j < 3; j++)
+	mat[i][j] = rotMat[i][j] * scale[j];
+      mat[i][3] = translation[i];
+    }
+}
@@ -0,0 +1,51 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_MANIP_STATE_H
+#define _GLEEM_MANIP_STATE_H
+
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+#include <gleem/Linalg.h>
+
+GLEEM_ENTER_NAMESPACE
+
+class Manip;
+
+/** A copy of a manipulator's user-visible state, taken on the thread
+    which owns the ManipManager so that callbacks running on other
+    threads need not touch the manipulator itself. Each manipulator
+    fills in the fields which apply to it; the others keep their
+    defaults. */
+
+class GLEEMDLL ManipState
+{
+public:
+  /** Default state has translation (0, 0, 0), the identity rotation
+      and scale (1, 1, 1) */
+  ManipState();
+
+  /** Computes the transform translation * rotation * scale, the
+      order in which the built-in manipulators apply them */
+  void getMatrix(GleemMat4f &mat) const;
+
+  GleemV3f translation;
+  GleemRot rotation;
+  GleemV3f scale;
+};
+
+/** Motion callbacks run on the callback worker thread (see
+    Manip::addWorkerMotionCallback()) receive the manipulator's state
+    as of the drag which queued them. The manipulator pointer only
+    identifies it; it may be in use by the owning thread, or deleted,
+    so the callback must not dereference it. */
+typedef void ManipStateCB(void *userData, Manip *manip,
+			  const ManipState &state);
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_MANIP_STATE_H
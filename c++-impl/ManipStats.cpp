@@ -0,0 +1,82 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <gleem/ManipStats.h>
+
+GLEEM_USE_NAMESPACE
+
+// Counters accumulated outside of any window's event or render
+static ManipStats unattributedStats;
+ManipStats *ManipStats::current = &unattributedStats;
+
+ManipStats::ManipStats()
+{
+  reset();
+}
+
+void
+ManipStats::reset()
+{
+  raysCast = 0;
+  manipsVisited = 0;
+  partsVisited = 0;
+  trianglesTested = 0;
+  boundRejects = 0;
+  hitsProduced = 0;
+  manipsRendered = 0;
+  manipsCulled = 0;
+  pickNanos = 0;
+  dragNanos = 0;
+  renderNanos = 0;
+}
+
+void
+ManipStats::add(const ManipStats &arg)
+{
+  raysCast += arg.raysCast;
+  manipsVisited += arg.manipsVisited;
+  partsVisited += arg.partsVisited;
+  trianglesTested += arg.trianglesTested;
+  boundRejects += arg.boundRejects;
+  hitsProduced += arg.hitsProduced;
+  manipsRendered += arg.manipsRendered;
+  manipsCulled += arg.manipsCulled;
+  pickNanos += arg.pickNanos;
+  dragNanos += arg.dragNanos;
+  renderNanos += arg.renderNanos;
+}
+
+GLEEM_ENTER_NAMESPACE
+ostream &
+operator<<(ostream &os, const ManipStats &stats)
+{
+  // Print the 64-bit times as doubles; not all iostreams support
+  // long long
+  os << "raysCast=" << stats.raysCast
+     << " manipsVisited=" << stats.manipsVisited
+     << " partsVisited=" << stats.partsVisited
+     << " trianglesTested=" << stats.trianglesTested
+     << " boundRejects=" << stats.boundRejects
+     << " hitsProduced=" << stats.hitsProduced
+     << " manipsRendered=" << stats.manipsRendered
+     << " manipsCulled=" << stats.manipsCulled
+     << " pickNanos=" << (double) stats.pickNanos
+     << " dragNanos=" << (double) stats.dragNanos
+     << " renderNanos=" << (double) stats.renderNanos;
+  return os;
+}
+GLEEM_EXIT_NAMESPACE
+
+StatsTimer::StatsTimer(GleemInt64 &accumulator) :
+  accumulator(accumulator)
+{
+  start = Clock::nanoTime();
+}
+
+StatsTimer::~StatsTimer()
+{
+  accumulator += Clock::nanoTime() - start;
+}
@@ -0,0 +1,101 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_MANIP_STATS_H
+#define _GLEEM_MANIP_STATS_H
+
+#include <iostream.h>
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+#include <gleem/Clock.h>
+
+GLEEM_ENTER_NAMESPACE
+
+/** Instrumentation counters for picking, dragging and rendering. The
+    ManipManager keeps one set per window for the frame in progress,
+    the last completed frame (a frame ends when render() draws the
+    window) and a running total; see ManipManager::getStats().
+
+    The counters are only maintained if gleem was compiled with
+    GLEEM_ENABLE_STATS defined (see STATS_SWITCH in the Makefile).
+    Otherwise the GLEEM_STATS_* macros below compile to nothing and
+    all counters stay zero. */
+
+class GLEEMDLL ManipStats
+{
+public:
+  /** Default constructor zeroes all counters */
+  ManipStats();
+
+  /** Zero all counters */
+  void reset();
+
+  /** Add all of the argument's counters to this one's */
+  void add(const ManipStats &arg);
+
+  /** Rays cast against the manipulators of a window */
+  unsigned long raysCast;
+  /** Manipulators considered by those rays */
+  unsigned long manipsVisited;
+  /** Calls to ManipPart::intersectRay() */
+  unsigned long partsVisited;
+  /** Ray-triangle intersection tests performed */
+  unsigned long trianglesTested;
+  /** Manipulators skipped because the ray missed their bounds */
+  unsigned long boundRejects;
+  /** HitPoints produced by intersectRay() */
+  unsigned long hitsProduced;
+  /** Manipulators drawn by ManipManager::render() */
+  unsigned long manipsRendered;
+  /** Manipulators skipped by render() because their bounds lay
+      outside the view frustum */
+  unsigned long manipsCulled;
+  /** Time spent picking, dragging (including motion callbacks) and
+      rendering, in nanoseconds */
+  GleemInt64 pickNanos;
+  GleemInt64 dragNanos;
+  GleemInt64 renderNanos;
+
+  /** The set of counters currently being accumulated into. The
+      ManipManager points this at the current window's counters while
+      it processes an event or renders; at other times it points at a
+      set of counters which are never reported. */
+  static ManipStats *current;
+
+  /** Convenience operator. Puts all counters on output stream on one
+      line as name=value pairs */
+  friend ostream &operator<<(ostream &os, const ManipStats &stats);
+};
+
+/** Adds the elapsed time between its construction and destruction to
+    a counter. Used by GLEEM_STATS_TIMER. */
+
+GLEEM_INTERNAL class GLEEMDLL StatsTimer
+{
+public:
+  StatsTimer(GleemInt64 &accumulator);
+  ~StatsTimer();
+
+private:
+  GleemInt64 &accumulator;
+  GleemInt64 start;
+};
+
+#ifdef GLEEM_ENABLE_STATS
+# define GLEEM_STATS_ADD(field, n) (ManipStats::current->field += (n))
+# define GLEEM_STATS_INC(field) GLEEM_STATS_ADD(field, 1)
+# define GLEEM_STATS_TIMER(field) \
+  StatsTimer _gleemStatsTimer_##field(ManipStats::current->field)
+#else
+# define GLEEM_STATS_ADD(field, n)
+# define GLEEM_STATS_INC(field)
+# define GLEEM_STATS_TIMER(field)
+#endif
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_MANIP_STATS_H
@@ -0,0 +1,74 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <gleem/ManipTargets.h>
+
+#ifdef GLEEM_USE_SSE
+# include <xmmintrin.h>
+#endif
+
+GLEEM_USE_NAMESPACE
+
+ManipTargets::ManipTargets()
+{
+  count = 0;
+  for (int i = 0; i < 12; i++)
+    {
+      src[i] = NULL;
+      dst[i] = NULL;
+    }
+}
+
+void
+ManipTargets::apply(const GleemMat4f &xform, int begin, int end) const
+{
+  int r, c;
+  int i = begin;
+#ifdef GLEEM_USE_SSE
+  // Four targets at a time; each element of xform is broadcast once
+  // per call rather than once per target
+  __m128 x[3][4];
+  for (r = 0; r < 3; r++)
+    for (c = 0; c < 4; c++)
+      x[r][c] = _mm_set1_ps(xform[r][c]);
+  for (; i + 4 <= end; i += 4)
+    {
+      for (c = 0; c < 4; c++)
+	{
+	  __m128 s0 = _mm_loadu_ps(src[c] + i);
+	  __m128 s1 = _mm_loadu_ps(src[4 + c] + i);
+	  __m128 s2 = _mm_loadu_ps(src[8 + c] + i);
+	  for (r = 0; r < 3; r++)
+	    {
+	      __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x[r][0], s0),
+					       _mm_mul_ps(x[r][1], s1)),
+				    _mm_mul_ps(x[r][2], s2));
+	      if (c == 3)
+		d = _mm_add_ps(d, x[r][3]);
+	      _mm_storeu_ps(dst[r * 4 + c] + i, d);
+	    }
+	}
+    }
+#endif
+  // The remaining targets (all of them without SSE). Element by
+  // element over the arrays, so that the compiler can vectorize it.
+  for (c = 0; c < 4; c++)
+    {
+      const float *s0 = src[c];
+      const float *s1 = src[4 + c];
+      const float *s2 = src[8 + c];
+      for (r = 0; r < 3; r++)
+	{
+	  float x0 = xform[r][0];
+	  float x1 = xform[r][1];
+	  float x2 = xform[r][2];
+	  float x3 = (c == 3) ? xform[r][3] : 0.0f;
+	  float *d = dst[r * 4 + c];
+	  for (int j = i; j < end; j++)
+	    d[j] = x0 * s0[j] + x1 * s1[j] + x2 * s2[j] + x3;
+	}
+    }
+}
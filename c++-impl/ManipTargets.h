@@ -0,0 +1,51 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_MANIP_TARGETS_H
+#define _GLEEM_MANIP_TARGETS_H
+
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+#include <gleem/Linalg.h>
+
+GLEEM_ENTER_NAMESPACE
+
+/** The transforms of a set of objects moved by one manipulator (see
+    Manip::setTargets()), in structure-of-arrays form. All of the
+    storage belongs to the application. Each transform is affine and
+    is stored as the top three rows of its 4x4 matrix (the bottom row
+    is taken to be 0 0 0 1), one array per element: element [r][c],
+    for r = 0..2 and c = 0..3, of target i's transform is
+    src[r * 4 + c][i]. The twelve arrays may be separate or may be
+    slices of one buffer. */
+
+class GLEEMDLL ManipTargets
+{
+public:
+  /** Default constructor has no targets and NULL arrays */
+  ManipTargets();
+
+  /** Number of targets */
+  int count;
+
+  /** The targets' transforms as of the time they were bound. Not
+      written by gleem. */
+  const float *src[12];
+
+  /** Receives the targets' current transforms; each must hold count
+      floats and must not overlap any of src */
+  float *dst[12];
+
+  /** Sets dst to xform * src for targets begin through end - 1.
+      xform must be affine. Uses SSE if gleem was compiled with
+      GLEEM_USE_SSE. */
+  void apply(const GleemMat4f &xform, int begin, int end) const;
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_MANIP_TARGETS_H
@@ -0,0 +1,114 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <iostream.h>
+#include <gleem/ObliqueTruncPyrMapping.h>
+
+GLEEM_USE_NAMESPACE
+
+ObliqueTruncPyrMapping::ObliqueTruncPyrMapping()
+{
+  setFrustum(-1, 1, -1, 1, 1);
+}
+
+ObliqueTruncPyrMapping::ObliqueTruncPyrMapping(float left, float right,
+					       float bottom, float top,
+					       float zNear)
+{
+  // The default frustum stays in effect if these values are rejected
+  setFrustum(-1, 1, -1, 1, 1);
+  setFrustum(left, right, bottom, top, zNear);
+}
+
+void
+ObliqueTruncPyrMapping::setFrustum(float left, float right,
+				   float bottom, float top,
+				   float zNear)
+{
+  if (zNear <= 0.0f)
+    {
+      cerr << "gleem::ObliqueTruncPyrMapping::setFrustum: ERROR: "
+	   << "zNear must be positive (was " << zNear << ")" << endl;
+      return;
+    }
+  this->left = left;
+  this->right = right;
+  this->bottom = bottom;
+  this->top = top;
+  this->zNear = zNear;
+  changed();
+}
+
+void
+ObliqueTruncPyrMapping::getFrustum(float &left, float &right,
+				   float &bottom, float &top,
+				   float &zNear) const
+{
+  left = this->left;
+  right = this->right;
+  bottom = this->bottom;
+  top = this->top;
+  zNear = this->zNear;
+}
+
+void
+ObliqueTruncPyrMapping::mapScreenToRay(const GleemV2f &screenCoords,
+				       const CameraParameters &params,
+				       GleemV3f &raySource,
+				       GleemV3f &rayDirection)
+{
+  ScreenToRayBasis basis;
+  computeBasis(params, basis);
+  basis.mapScreenToRay(screenCoords, raySource, rayDirection);
+}
+
+bool
+ObliqueTruncPyrMapping::isAffine() const
+{
+  return true;
+}
+
+void
+ObliqueTruncPyrMapping::computeBasis(const CameraParameters &params,
+				     ScreenToRayBasis &basis)
+{
+  GleemV3f fwd, up, rightDir;
+  computeCameraFrame(params, fwd, up, rightDir);
+  // Scale the near plane window to unit distance so that the
+  // central direction has a unit forward component, as in
+  // RightTruncPyrMapping
+  float invNear = 1.0f / zNear;
+  basis.origin = params.position;
+  basis.originDu.setValue(0, 0, 0);
+  basis.originDv.setValue(0, 0, 0);
+  basis.direction = fwd;
+  GleemV3f::addScaled(basis.direction, 0.5f * (left + right) * invNear,
+		      rightDir, basis.direction);
+  GleemV3f::addScaled(basis.direction, 0.5f * (bottom + top) * invNear,
+		      up, basis.direction);
+  GleemV3f::scale(rightDir, 0.5f * (right - left) * invNear,
+		  basis.directionDu);
+  GleemV3f::scale(up, 0.5f * (top - bottom) * invNear, basis.directionDv);
+}
+
+void
+ObliqueTruncPyrMapping::mapScreenToRays(int numPoints,
+					const GleemV2f *screenCoords,
+					const CameraParameters &params,
+					GleemV3f *raySources,
+					GleemV3f *rayDirections)
+{
+  ScreenToRayBasis basis;
+  computeBasis(params, basis);
+  for (int i = 0; i < numPoints; i++)
+    {
+      raySources[i] = basis.origin;
+      GleemV3f::addScaled(basis.direction, screenCoords[i][0],
+			  basis.directionDu, rayDirections[i]);
+      GleemV3f::addScaled(rayDirections[i], screenCoords[i][1],
+			  basis.directionDv, rayDirections[i]);
+    }
+}
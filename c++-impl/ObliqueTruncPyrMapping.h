@@ -0,0 +1,73 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_OBLIQUE_TRUNC_PYR_MAPPING_H
+#define _GLEEM_OBLIQUE_TRUNC_PYR_MAPPING_H
+
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+#include <gleem/ScreenToRayMapping.h>
+
+GLEEM_ENTER_NAMESPACE
+
+/** An asymmetric (off-axis) perspective frustum, as set up by
+    glFrustum(). This is useful for tiled displays and stereo, where
+    the image plane window is not centered on the viewing direction.
+    As with OrthographicMapping, the frustum's extents are properties
+    of the mapping and only the position, forwardDirection and
+    upDirection of the CameraParameters are used. */
+
+class GLEEMDLL ObliqueTruncPyrMapping : public ScreenToRayMapping
+{
+public:
+  /** Default is the symmetric frustum (-1, 1, -1, 1, 1), which has a
+      90 degree field of view */
+  ObliqueTruncPyrMapping();
+  /** See setFrustum(); if zNear is not positive an error is printed
+      and the default frustum is used */
+  ObliqueTruncPyrMapping(float left, float right,
+			 float bottom, float top,
+			 float zNear);
+
+  /** Set the extents of the frustum's cross-section at distance
+      zNear (which must be positive) along the viewing direction,
+      measured along the camera's right and up directions, as in the
+      corresponding arguments to glFrustum(). The far plane does not
+      matter for picking. */
+  void setFrustum(float left, float right,
+		  float bottom, float top,
+		  float zNear);
+  void getFrustum(float &left, float &right,
+		  float &bottom, float &top,
+		  float &zNear) const;
+
+  /** Implementation of ScreenToRayMapping interface */
+  virtual void mapScreenToRay(const GleemV2f &screenCoords,
+			      const CameraParameters &params,
+			      GleemV3f &raySource,
+			      GleemV3f &rayDirection);
+  virtual bool isAffine() const;
+  virtual void computeBasis(const CameraParameters &params,
+			    ScreenToRayBasis &basis);
+  /** All rays share the camera position as their source */
+  virtual void mapScreenToRays(int numPoints,
+			       const GleemV2f *screenCoords,
+			       const CameraParameters &params,
+			       GleemV3f *raySources,
+			       GleemV3f *rayDirections);
+
+private:
+  float left;
+  float right;
+  float bottom;
+  float top;
+  float zNear;
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_OBLIQUE_TRUNC_PYR_MAPPING_H
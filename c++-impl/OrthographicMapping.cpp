@@ -0,0 +1,96 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <gleem/OrthographicMapping.h>
+
+GLEEM_USE_NAMESPACE
+
+OrthographicMapping::OrthographicMapping()
+{
+  setExtents(-1, 1, -1, 1);
+}
+
+OrthographicMapping::OrthographicMapping(float left, float right,
+					 float bottom, float top)
+{
+  setExtents(left, right, bottom, top);
+}
+
+void
+OrthographicMapping::setExtents(float left, float right,
+				float bottom, float top)
+{
+  this->left = left;
+  this->right = right;
+  this->bottom = bottom;
+  this->top = top;
+  changed();
+}
+
+void
+OrthographicMapping::getExtents(float &left, float &right,
+				float &bottom, float &top) const
+{
+  left = this->left;
+  right = this->right;
+  bottom = this->bottom;
+  top = this->top;
+}
+
+void
+OrthographicMapping::mapScreenToRay(const GleemV2f &screenCoords,
+				    const CameraParameters &params,
+				    GleemV3f &raySource,
+				    GleemV3f &rayDirection)
+{
+  ScreenToRayBasis basis;
+  computeBasis(params, basis);
+  basis.mapScreenToRay(screenCoords, raySource, rayDirection);
+}
+
+bool
+OrthographicMapping::isAffine() const
+{
+  return true;
+}
+
+void
+OrthographicMapping::computeBasis(const CameraParameters &params,
+				  ScreenToRayBasis &basis)
+{
+  GleemV3f fwd, up, rightDir;
+  computeCameraFrame(params, fwd, up, rightDir);
+  // Screen coordinate -1 maps to left (bottom), 1 to right (top)
+  basis.origin = params.position;
+  GleemV3f::addScaled(basis.origin, 0.5f * (left + right), rightDir,
+		      basis.origin);
+  GleemV3f::addScaled(basis.origin, 0.5f * (bottom + top), up,
+		      basis.origin);
+  GleemV3f::scale(rightDir, 0.5f * (right - left), basis.originDu);
+  GleemV3f::scale(up, 0.5f * (top - bottom), basis.originDv);
+  basis.direction = fwd;
+  basis.directionDu.setValue(0, 0, 0);
+  basis.directionDv.setValue(0, 0, 0);
+}
+
+void
+OrthographicMapping::mapScreenToRays(int numPoints,
+				     const GleemV2f *screenCoords,
+				     const CameraParameters &params,
+				     GleemV3f *raySources,
+				     GleemV3f *rayDirections)
+{
+  ScreenToRayBasis basis;
+  computeBasis(params, basis);
+  for (int i = 0; i < numPoints; i++)
+    {
+      GleemV3f::addScaled(basis.origin, screenCoords[i][0],
+			  basis.originDu, raySources[i]);
+      GleemV3f::addScaled(raySources[i], screenCoords[i][1],
+			  basis.originDv, raySources[i]);
+      rayDirections[i] = basis.direction;
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_ORTHOGRAPHIC_MAPPING_H
+#define _GLEEM_ORTHOGRAPHIC_MAPPING_H
+
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+#include <gleem/ScreenToRayMapping.h>
+
+GLEEM_ENTER_NAMESPACE
+
+/** A parallel projection, as set up by glOrtho(). The extents of the
+    view volume are properties of the mapping rather than of the
+    CameraParameters; only the position, forwardDirection and
+    upDirection of the camera are used. All rays are parallel to the
+    forward direction and start in the plane through the camera
+    position. Install it for a window with
+    ManipManager::setScreenToRayMapping(). If you change the extents
+    (for example, to zoom), the window's ray basis is recomputed at
+    its next ManipManager::updateCameraParameters(), even if the
+    camera itself has not moved. */
+
+class GLEEMDLL OrthographicMapping : public ScreenToRayMapping
+{
+public:
+  /** Default extents are -1 to 1 both horizontally and vertically */
+  OrthographicMapping();
+  OrthographicMapping(float left, float right, float bottom, float top);
+
+  /** Set the extents of the view volume, measured from the camera
+      position along its right and up directions, as in the
+      corresponding arguments to glOrtho(). */
+  void setExtents(float left, float right, float bottom, float top);
+  void getExtents(float &left, float &right,
+		  float &bottom, float &top) const;
+
+  /** Implementation of ScreenToRayMapping interface */
+  virtual void mapScreenToRay(const GleemV2f &screenCoords,
+			      const CameraParameters &params,
+			      GleemV3f &raySource,
+			      GleemV3f &rayDirection);
+  virtual bool isAffine() const;
+  virtual void computeBasis(const CameraParameters &params,
+			    ScreenToRayBasis &basis);
+  /** All rays share the forward direction */
+  virtual void mapScreenToRays(int numPoints,
+			       const GleemV2f *screenCoords,
+			       const CameraParameters &params,
+			       GleemV3f *raySources,
+			       GleemV3f *rayDirections);
+
+private:
+  float left;
+  float right;
+  float bottom;
+  float top;
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_ORTHOGRAPHIC_MAPPING_H
@@ -19,6 +19,10 @@ GLEEM_USE_NAMESPACE
 // create an orthonormal basis in intersectRayWithTriangle.
 static const float epsilon = 1.0e-3;
 
+// Slack, in barycentric coordinates, for the edge-based test, so that
+// rays through a shared edge do not fall between its two triangles
+static const float mtEpsilon = 1.0e-5f;
+
 RayTriangleIntersection::ResultCode
 RayTriangleIntersection::intersectRayWithTriangle(const GleemV3f &rayOrigin,
 						  const GleemV3f &rayDirection,
@@ -132,6 +136,45 @@ RayTriangleIntersection::intersectRayWithTriangle(const GleemV3f &rayOrigin,
   return RTI_INTERSECTION;
 }
 
+RayTriangleIntersection::ResultCode
+RayTriangleIntersection::
+intersectRayWithTriangleEdges(const GleemV3f &rayOrigin,
+			      const GleemV3f &rayDirection,
+			      const GleemV3f &v0,
+			      const GleemV3f &edge1,
+			      const GleemV3f &edge2,
+			      GleemV3f &intersectionPt,
+			      float &t)
+{
+  // Solve rayOrigin + t * rayDirection = v0 + u * edge1 + v * edge2
+  // for (t, u, v) by Cramer's rule, expressing each determinant as a
+  // scalar triple product so the cross products can be shared.
+  GleemV3f p;
+  GleemV3f::cross(rayDirection, edge2, p);
+  float det = edge1.dot(p);
+  // Scale the parallel/degenerate test by the sizes involved so that
+  // it does not depend on the units of the geometry
+  float scale = (rayDirection.lengthSquared() *
+		 edge1.lengthSquared() *
+		 edge2.lengthSquared());
+  if (det * det <= scale * mtEpsilon * mtEpsilon)
+    return RTI_ERROR;
+  float invDet = 1.0f / det;
+  GleemV3f s = rayOrigin - v0;
+  float u = s.dot(p) * invDet;
+  if ((u < -mtEpsilon) || (u > 1.0f + mtEpsilon))
+    return RTI_NO_INTERSECTION;
+  GleemV3f q;
+  GleemV3f::cross(s, edge1, q);
+  float v = rayDirection.dot(q) * invDet;
+  if ((v < -mtEpsilon) || (u + v > 1.0f + mtEpsilon))
+    return RTI_NO_INTERSECTION;
+  t = edge2.dot(q) * invDet;
+  GleemV3f::addScaled(v0, u, edge1, intersectionPt);
+  GleemV3f::addScaled(intersectionPt, v, edge2, intersectionPt);
+  return RTI_INTERSECTION;
+}
+
 bool
 RayTriangleIntersection::approxOnSameSide(GleemV2f &linePt1, GleemV2f &linePt2,
 					  GleemV2f &testPt1, GleemV2f &testPt2)
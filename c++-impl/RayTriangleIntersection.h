@@ -41,6 +41,21 @@ public:
 					     GleemV3f &intersectionPt,
 					     float &t);
 
+  // Same as above, but takes the triangle as one vertex v0 and the
+  // two edges edge1 = v1 - v0 and edge2 = v2 - v0, which callers
+  // with fixed geometry can precompute. Uses the Moller-Trumbore
+  // algorithm, which needs no matrix inverse. Rays are two-sided.
+  // Returns ERROR if the triangle is degenerate or the ray is
+  // parallel to its plane.
+  static ResultCode
+  intersectRayWithTriangleEdges(const GleemV3f &rayOrigin,
+				const GleemV3f &rayDirection,
+				const GleemV3f &v0,
+				const GleemV3f &edge1,
+				const GleemV3f &edge2,
+				GleemV3f &intersectionPt,
+				float &t);
+
 private:
   static bool approxOnSameSide(GleemV2f &linePt1, GleemV2f &linePt2,
 			       GleemV2f &testPt1, GleemV2f &testPt2);
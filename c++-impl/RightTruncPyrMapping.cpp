@@ -15,17 +15,51 @@ RightTruncPyrMapping::mapScreenToRay(const GleemV2f &screenCoords,
 				     const CameraParameters &params,
 				     GleemV3f &raySource,
 				     GleemV3f &rayDirection)
+{
+  ScreenToRayBasis basis;
+  computeBasis(params, basis);
+  basis.mapScreenToRay(screenCoords, raySource, rayDirection);
+}
+
+bool
+RightTruncPyrMapping::isAffine() const
+{
+  return true;
+}
+
+void
+RightTruncPyrMapping::computeBasis(const CameraParameters &params,
+				   ScreenToRayBasis &basis)
 {
   GleemV3f fwd, up, right;
-  fwd = params.forwardDirection;
-  up = params.upDirection;
-  GleemV3f::cross(fwd, up, right);
-  fwd.normalize();
-  up.normalize();
-  right.normalize();
-  float horizFOV = atan(params.imagePlaneAspectRatio * tan(params.vertFOV));
-  right *= (tan(horizFOV) * screenCoords[0]);
-  up *= (tan(params.vertFOV) * screenCoords[1]);
-  raySource = params.position;
-  rayDirection = fwd + up + right;
+  computeCameraFrame(params, fwd, up, right);
+  // The horizontal half-angle is atan(aspect * tan(vertFOV)), so its
+  // tangent is simply aspect * tan(vertFOV)
+  float tanVertFOV = tan(params.vertFOV);
+  float tanHorizFOV = params.imagePlaneAspectRatio * tanVertFOV;
+  basis.origin = params.position;
+  basis.originDu.setValue(0, 0, 0);
+  basis.originDv.setValue(0, 0, 0);
+  basis.direction = fwd;
+  GleemV3f::scale(right, tanHorizFOV, basis.directionDu);
+  GleemV3f::scale(up, tanVertFOV, basis.directionDv);
+}
+
+void
+RightTruncPyrMapping::mapScreenToRays(int numPoints,
+				      const GleemV2f *screenCoords,
+				      const CameraParameters &params,
+				      GleemV3f *raySources,
+				      GleemV3f *rayDirections)
+{
+  ScreenToRayBasis basis;
+  computeBasis(params, basis);
+  for (int i = 0; i < numPoints; i++)
+    {
+      raySources[i] = basis.origin;
+      GleemV3f::addScaled(basis.direction, screenCoords[i][0],
+			  basis.directionDu, rayDirections[i]);
+      GleemV3f::addScaled(rayDirections[i], screenCoords[i][1],
+			  basis.directionDv, rayDirections[i]);
+    }
 }
@@ -14,8 +14,9 @@
 
 GLEEM_ENTER_NAMESPACE
 
-/** The only mapping gleem supports right now -- a right truncated
-    pyramid. */
+/** The default mapping -- a right truncated pyramid, as set up by
+    gluPerspective(). See also OrthographicMapping and
+    ObliqueTruncPyrMapping. */
 
 GLEEM_INTERNAL class GLEEMDLL RightTruncPyrMapping : public ScreenToRayMapping
 {
@@ -24,6 +25,15 @@ public:
 			      const CameraParameters &params,
 			      GleemV3f &raySource,
 			      GleemV3f &rayDirection);
+  virtual bool isAffine() const;
+  virtual void computeBasis(const CameraParameters &params,
+			    ScreenToRayBasis &basis);
+  /** All rays share the camera position as their source */
+  virtual void mapScreenToRays(int numPoints,
+			       const GleemV2f *screenCoords,
+			       const CameraParameters &params,
+			       GleemV3f *raySources,
+			       GleemV3f *rayDirections);
 };
 
 GLEEM_EXIT_NAMESPACE
@@ -0,0 +1,57 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <gleem/ScreenToRayBasis.h>
+
+GLEEM_USE_NAMESPACE
+
+ScreenToRayBasis::ScreenToRayBasis()
+{
+  origin.setValue(0, 0, 0);
+  originDu.setValue(0, 0, 0);
+  originDv.setValue(0, 0, 0);
+  direction.setValue(0, 0, 0);
+  directionDu.setValue(0, 0, 0);
+  directionDv.setValue(0, 0, 0);
+}
+
+void
+ScreenToRayBasis::mapScreenToRay(const GleemV2f &screenCoords,
+				 GleemV3f &raySource,
+				 GleemV3f &rayDirection) const
+{
+  float u = screenCoords[0];
+  float v = screenCoords[1];
+  GleemV3f::addScaled(origin, u, originDu, raySource);
+  GleemV3f::addScaled(raySource, v, originDv, raySource);
+  GleemV3f::addScaled(direction, u, directionDu, rayDirection);
+  GleemV3f::addScaled(rayDirection, v, directionDv, rayDirection);
+}
+
+void
+ScreenToRayBasis::mapScreenToRays(int numPoints,
+				  const GleemV2f *screenCoords,
+				  GleemV3f *raySources,
+				  GleemV3f *rayDirections) const
+{
+  for (int i = 0; i < numPoints; i++)
+    mapScreenToRay(screenCoords[i], raySources[i], rayDirections[i]);
+}
+
+void
+ScreenToRayBasis::makePixelBasis(int xSize, int ySize,
+				 ScreenToRayBasis &pixelBasis) const
+{
+  // u = 2x / (xSize - 1) - 1, v = 1 - 2y / (ySize - 1)
+  float xScale = 2.0f / (float) ((xSize > 1) ? (xSize - 1) : 1);
+  float yScale = -2.0f / (float) ((ySize > 1) ? (ySize - 1) : 1);
+  pixelBasis.origin = origin - originDu + originDv;
+  GleemV3f::scale(originDu, xScale, pixelBasis.originDu);
+  GleemV3f::scale(originDv, yScale, pixelBasis.originDv);
+  pixelBasis.direction = direction - directionDu + directionDv;
+  GleemV3f::scale(directionDu, xScale, pixelBasis.directionDu);
+  GleemV3f::scale(directionDv, yScale, pixelBasis.directionDv);
+}
@@ -0,0 +1,64 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_SCREEN_TO_RAY_BASIS_H
+#define _GLEEM_SCREEN_TO_RAY_BASIS_H
+
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+#include <gleem/Linalg.h>
+
+GLEEM_ENTER_NAMESPACE
+
+/** A precomputed affine mapping from screen coordinates (u, v) to a
+    ray:
+
+    raySource    = origin    + u * originDu    + v * originDv
+    rayDirection = direction + u * directionDu + v * directionDv
+
+    All of the mappings gleem supplies have this form, so once a basis
+    has been computed from a set of camera parameters each ray costs
+    only a few multiply-adds. Perspective frusta have zero originDu
+    and originDv; parallel projections have zero directionDu and
+    directionDv. The ray directions are not normalized. */
+
+class GLEEMDLL ScreenToRayBasis
+{
+public:
+  /** Default constructor sets all vectors to zero */
+  ScreenToRayBasis();
+
+  GleemV3f origin;
+  GleemV3f originDu;
+  GleemV3f originDv;
+  GleemV3f direction;
+  GleemV3f directionDu;
+  GleemV3f directionDv;
+
+  /** Map a single point */
+  void mapScreenToRay(const GleemV2f &screenCoords,
+		      GleemV3f &raySource,
+		      GleemV3f &rayDirection) const;
+
+  /** Map numPoints points, writing the rays into the parallel output
+      arrays */
+  void mapScreenToRays(int numPoints,
+		       const GleemV2f *screenCoords,
+		       GleemV3f *raySources,
+		       GleemV3f *rayDirections) const;
+
+  /** Given a basis for normalized screen coordinates (see
+      ScreenToRayMapping), compute the equivalent basis taking GLUT
+      window coordinates (origin at upper left, y increasing
+      downward) for a window of the given size. */
+  void makePixelBasis(int xSize, int ySize,
+		      ScreenToRayBasis &pixelBasis) const;
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_SCREEN_TO_RAY_BASIS_H
@@ -0,0 +1,85 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <gleem/ScreenToRayMapping.h>
+
+GLEEM_USE_NAMESPACE
+
+ScreenToRayMapping::ScreenToRayMapping()
+{
+  generation = 0;
+}
+
+ScreenToRayMapping::~ScreenToRayMapping()
+{
+}
+
+unsigned long
+ScreenToRayMapping::getGeneration() const
+{
+  return generation;
+}
+
+void
+ScreenToRayMapping::changed()
+{
+  ++generation;
+}
+
+bool
+ScreenToRayMapping::isAffine() const
+{
+  return false;
+}
+
+void
+ScreenToRayMapping::computeBasis(const CameraParameters &params,
+				 ScreenToRayBasis &basis)
+{
+  // Sample the mapping at three points. This is exact for mappings
+  // which are affine in the screen coordinates.
+  GleemV3f source, dir;
+  mapScreenToRay(GleemV2f(0, 0), params, basis.origin, basis.direction);
+  mapScreenToRay(GleemV2f(1, 0), params, source, dir);
+  GleemV3f::sub(source, basis.origin, basis.originDu);
+  GleemV3f::sub(dir, basis.direction, basis.directionDu);
+  mapScreenToRay(GleemV2f(0, 1), params, source, dir);
+  GleemV3f::sub(source, basis.origin, basis.originDv);
+  GleemV3f::sub(dir, basis.direction, basis.directionDv);
+}
+
+void
+ScreenToRayMapping::computeCameraFrame(const CameraParameters &params,
+				       GleemV3f &fwd,
+				       GleemV3f &up,
+				       GleemV3f &right)
+{
+  fwd = params.forwardDirection;
+  up = params.upDirection;
+  GleemV3f::cross(fwd, up, right);
+  fwd.normalize();
+  up.normalize();
+  right.normalize();
+}
+
+void
+ScreenToRayMapping::mapScreenToRays(int numPoints,
+				    const GleemV2f *screenCoords,
+				    const CameraParameters &params,
+				    GleemV3f *raySources,
+				    GleemV3f *rayDirections)
+{
+  if (!isAffine())
+    {
+      for (int i = 0; i < numPoints; i++)
+	mapScreenToRay(screenCoords[i], params, raySources[i],
+		       rayDirections[i]);
+      return;
+    }
+  ScreenToRayBasis basis;
+  computeBasis(params, basis);
+  basis.mapScreenToRays(numPoints, screenCoords, raySources, rayDirections);
+}
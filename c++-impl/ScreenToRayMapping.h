@@ -11,6 +11,7 @@
 #include <gleem/GleemDLL.h>
 #include <gleem/Util.h>
 #include <gleem/CameraParameters.h>
+#include <gleem/ScreenToRayBasis.h>
 #include <gleem/Linalg.h>
 
 GLEEM_ENTER_NAMESPACE
@@ -30,15 +31,71 @@ GLEEM_ENTER_NAMESPACE
     center = (0, 0)
 
     The application is responsible for specifying the window size to
-    allow the ManipManager to compute these coordinates. */
+    allow the ManipManager to compute these coordinates.
+
+    Since the camera parameters change far less often than rays are
+    cast, the ManipManager does not call mapScreenToRay() per mouse
+    event for mappings which are affine (see isAffine()). Instead it
+    calls computeBasis() when the camera parameters are updated and
+    generates rays from the resulting ScreenToRayBasis. Other mappings
+    (for example fisheye or distortion-corrected lenses) are called
+    for every ray. */
 
 class GLEEMDLL ScreenToRayMapping
 {
 public:
+  ScreenToRayMapping();
+  virtual ~ScreenToRayMapping();
+
   virtual void mapScreenToRay(const GleemV2f &screenCoords,
 			      const CameraParameters &params,
 			      GleemV3f &raySource,
 			      GleemV3f &rayDirection) = 0;
+
+  /** Returns true if mapScreenToRay() is affine in the screen
+      coordinates, so that the basis computed by computeBasis()
+      reproduces it exactly. The default returns false, which is
+      always safe; the mappings gleem supplies return true. */
+  virtual bool isAffine() const;
+
+  /** Compute the affine basis equivalent to mapScreenToRay() for the
+      given camera parameters. The default implementation samples
+      mapScreenToRay() at three points, which is exact as long as the
+      mapping is affine in the screen coordinates; subclasses should
+      override it to compute the basis directly. */
+  virtual void computeBasis(const CameraParameters &params,
+			    ScreenToRayBasis &basis);
+
+  /** Map numPoints screen coordinates to rays, writing them into the
+      parallel output arrays. The default implementation computes the
+      basis once and maps all points through it if the mapping is
+      affine, and otherwise calls mapScreenToRay() for each point. */
+  virtual void mapScreenToRays(int numPoints,
+			       const GleemV2f *screenCoords,
+			       const CameraParameters &params,
+			       GleemV3f *raySources,
+			       GleemV3f *rayDirections);
+
+  /** Incremented each time the mapping's own settings change, so
+      that the ManipManager knows to recompute the bases of the
+      windows which use it even if their camera parameters have not
+      changed */
+  unsigned long getGeneration() const;
+
+protected:
+  /** Subclasses call this from every function which changes how they
+      map screen coordinates to rays */
+  void changed();
+
+  /** Compute the normalized forward, up and right vectors of the
+      camera described by params */
+  static void computeCameraFrame(const CameraParameters &params,
+				 GleemV3f &fwd,
+				 GleemV3f &up,
+				 GleemV3f &right);
+
+private:
+  unsigned long generation;
 };
 
 GLEEM_EXIT_NAMESPACE
@@ -0,0 +1,110 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#include <gleem/TaskPool.h>
+
+GLEEM_USE_NAMESPACE
+
+TaskPool::TaskPool(int numThreads)
+{
+  curTask = NULL;
+  curArg = NULL;
+  numTasks = 0;
+  nextTask = 0;
+  unfinished = 0;
+  quitting = false;
+  for (int i = 0; i < numThreads; i++)
+    {
+      Worker *worker = new Worker();
+      worker->pool = this;
+      worker->thread = Thread::startJoinable(&TaskPool::threadMain, worker);
+      if (worker->thread == NULL)
+	{
+	  delete worker;
+	  break;
+	}
+      workers.push_back(worker);
+    }
+}
+
+TaskPool::~TaskPool()
+{
+  int i;
+  mutex.lock();
+  quitting = true;
+  mutex.unlock();
+  for (i = 0; i < workers.size(); i++)
+    workers[i]->start.set();
+  for (i = 0; i < workers.size(); i++)
+    {
+      Thread::join(workers[i]->thread);
+      delete workers[i];
+    }
+}
+
+int
+TaskPool::getNumThreads() const
+{
+  return workers.size();
+}
+
+void
+TaskPool::run(Task *task, void *arg, int numTasks)
+{
+  if (numTasks <= 0)
+    return;
+  mutex.lock();
+  curTask = task;
+  curArg = arg;
+  this->numTasks = numTasks;
+  nextTask = 0;
+  unfinished = numTasks;
+  mutex.unlock();
+  // Wake no more threads than there are tasks for; the caller takes
+  // one of them itself
+  for (int i = 0; (i < workers.size()) && (i < numTasks - 1); i++)
+    workers[i]->start.set();
+  work();
+  // Exactly one set() per loop, from whichever thread finishes last
+  done.wait();
+}
+
+void
+TaskPool::threadMain(void *arg)
+{
+  Worker *worker = (Worker *) arg;
+  TaskPool *pool = worker->pool;
+  while (true)
+    {
+      worker->start.wait();
+      pool->mutex.lock();
+      bool quit = pool->quitting;
+      pool->mutex.unlock();
+      if (quit)
+	break;
+      // A thread woken for a loop which has already finished finds
+      // no tasks left, or joins the next loop, which is harmless
+      pool->work();
+    }
+}
+
+void
+TaskPool::work()
+{
+  mutex.lock();
+  while (nextTask < numTasks)
+    {
+      int index = nextTask++;
+      Task *task = curTask;
+      void *arg = curArg;
+      mutex.unlock();
+      (*task)(arg, index);
+      mutex.lock();
+      if (--unfinished == 0)
+	done.set();
+    }
+  mutex.unlock();
+}
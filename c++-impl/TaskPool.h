@@ -0,0 +1,80 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_TASK_POOL_H
+#define _GLEEM_TASK_POOL_H
+
+#include <vector.h>
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+#include <gleem/Thread.h>
+
+GLEEM_ENTER_NAMESPACE
+
+/** A fixed set of threads which, together with the calling thread,
+    run the pieces of a data-parallel loop. Threads which can not be
+    started (for example when compiled with GLEEM_NO_THREADS) are
+    simply left out, so run() always completes, if only on the
+    calling thread. Only one thread may call run() at a time. */
+
+GLEEM_INTERNAL class GLEEMDLL TaskPool
+{
+public:
+  typedef void Task(void *arg, int index);
+
+  /** Starts up to numThreads threads */
+  TaskPool(int numThreads);
+  /** Joins the threads */
+  ~TaskPool();
+
+  /** Number of threads actually running, not counting the caller of
+      run() */
+  int getNumThreads() const;
+
+  /** Calls task(arg, i) for each i from 0 to numTasks - 1, spread in
+      arbitrary order over the pool's threads and the calling thread,
+      and returns once all of the calls have finished */
+  void run(Task *task, void *arg, int numTasks);
+
+private:
+  // Not copyable
+  TaskPool(const TaskPool &);
+  TaskPool &operator=(const TaskPool &);
+
+  class Worker
+  {
+  public:
+    TaskPool *pool;
+    Thread::Handle thread;
+    /** Set when there is work or the thread should quit */
+    Event start;
+  };
+
+  static void threadMain(void *arg);
+  /** Runs tasks of the current loop until none are left */
+  void work();
+
+  vector<Worker *> workers;
+
+  /** Protects everything below it */
+  Mutex mutex;
+  Task *curTask;
+  void *curArg;
+  int numTasks;
+  /** Index of the next task to hand out */
+  int nextTask;
+  /** Tasks handed out or waiting which have not finished */
+  int unfinished;
+  bool quitting;
+
+  /** Set when the last task of a loop finishes */
+  Event done;
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_TASK_POOL_H
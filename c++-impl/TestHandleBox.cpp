@@ -5,6 +5,7 @@
  */
 
 #include <math.h>
+#include <stdlib.h>
 #ifdef WIN32
 # include <windows.h>
 #endif
@@ -83,6 +84,11 @@ main(int argc, char **argv)
   glutDisplayFunc(display);
   glutReshapeFunc(reshape);
   ManipManager::init();
+  // Set GLEEM_EVENT_LOG to record the session for replay with
+  // "bench -replay"
+  const char *logName = getenv("GLEEM_EVENT_LOG");
+  if (logName != NULL)
+    ManipManager::getManipManager()->startRecording(logName);
 
   params.position.setValue(0, 0, 0);
   params.forwardDirection.setValue(0, 0, -1);
@@ -0,0 +1,257 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#if defined(WIN32)
+# include <windows.h>
+#elif !defined(GLEEM_NO_THREADS)
+# include <pthread.h>
+#endif
+#include <stddef.h>
+#include <gleem/Thread.h>
+
+GLEEM_USE_NAMESPACE
+
+Thread::ID
+Thread::getCurrentID()
+{
+#if defined(WIN32)
+  return (ID) GetCurrentThreadId();
+#elif !defined(GLEEM_NO_THREADS)
+  // pthread_t is an integer or pointer on all of the platforms we
+  // support
+  return (ID) pthread_self();
+#else
+  return 0;
+#endif
+}
+
+#if defined(WIN32) || !defined(GLEEM_NO_THREADS)
+// Passed through the platform's thread creation function
+class ThreadStart
+{
+public:
+  Thread::Function *function;
+  void *arg;
+};
+#endif
+
+#if defined(WIN32)
+static DWORD WINAPI
+threadMain(LPVOID arg)
+{
+  ThreadStart *start = (ThreadStart *) arg;
+  (*start->function)(start->arg);
+  delete start;
+  return 0;
+}
+#elif !defined(GLEEM_NO_THREADS)
+extern "C" {
+static void *
+threadMain(void *arg)
+{
+  ThreadStart *start = (ThreadStart *) arg;
+  (*start->function)(start->arg);
+  delete start;
+  return NULL;
+}
+}
+#endif
+
+bool
+Thread::start(Function *function, void *arg)
+{
+#if defined(WIN32)
+  ThreadStart *start = new ThreadStart;
+  start->function = function;
+  start->arg = arg;
+  DWORD id;
+  HANDLE handle = CreateThread(NULL, 0, threadMain, start, 0, &id);
+  if (handle == NULL)
+    {
+      delete start;
+      return false;
+    }
+  CloseHandle(handle);
+  return true;
+#elif !defined(GLEEM_NO_THREADS)
+  ThreadStart *start = new ThreadStart;
+  start->function = function;
+  start->arg = arg;
+  pthread_t thread;
+  if (pthread_create(&thread, NULL, threadMain, start) != 0)
+    {
+      delete start;
+      return false;
+    }
+  pthread_detach(thread);
+  return true;
+#else
+  return false;
+#endif
+}
+
+Thread::Handle
+Thread::startJoinable(Function *function, void *arg)
+{
+#if defined(WIN32)
+  ThreadStart *start = new ThreadStart;
+  start->function = function;
+  start->arg = arg;
+  DWORD id;
+  HANDLE handle = CreateThread(NULL, 0, threadMain, start, 0, &id);
+  if (handle == NULL)
+    delete start;
+  return (Handle) handle;
+#elif !defined(GLEEM_NO_THREADS)
+  ThreadStart *start = new ThreadStart;
+  start->function = function;
+  start->arg = arg;
+  pthread_t *thread = new pthread_t;
+  if (pthread_create(thread, NULL, threadMain, start) != 0)
+    {
+      delete start;
+      delete thread;
+      return NULL;
+    }
+  return (Handle) thread;
+#else
+  return NULL;
+#endif
+}
+
+void
+Thread::join(Handle thread)
+{
+#if defined(WIN32)
+  WaitForSingleObject((HANDLE) thread, INFINITE);
+  CloseHandle((HANDLE) thread);
+#elif !defined(GLEEM_NO_THREADS)
+  pthread_join(*(pthread_t *) thread, NULL);
+  delete (pthread_t *) thread;
+#endif
+}
+
+//
+// Mutex
+//
+
+Mutex::Mutex()
+{
+#if defined(WIN32)
+  CRITICAL_SECTION *section = new CRITICAL_SECTION;
+  InitializeCriticalSection(section);
+  impl = section;
+#elif !defined(GLEEM_NO_THREADS)
+  pthread_mutex_t *mutex = new pthread_mutex_t;
+  pthread_mutex_init(mutex, NULL);
+  impl = mutex;
+#else
+  impl = NULL;
+#endif
+}
+
+Mutex::~Mutex()
+{
+#if defined(WIN32)
+  DeleteCriticalSection((CRITICAL_SECTION *) impl);
+  delete (CRITICAL_SECTION *) impl;
+#elif !defined(GLEEM_NO_THREADS)
+  pthread_mutex_destroy((pthread_mutex_t *) impl);
+  delete (pthread_mutex_t *) impl;
+#endif
+}
+
+void
+Mutex::lock()
+{
+#if defined(WIN32)
+  EnterCriticalSection((CRITICAL_SECTION *) impl);
+#elif !defined(GLEEM_NO_THREADS)
+  pthread_mutex_lock((pthread_mutex_t *) impl);
+#endif
+}
+
+void
+Mutex::unlock()
+{
+#if defined(WIN32)
+  LeaveCriticalSection((CRITICAL_SECTION *) impl);
+#elif !defined(GLEEM_NO_THREADS)
+  pthread_mutex_unlock((pthread_mutex_t *) impl);
+#endif
+}
+
+//
+// Event
+//
+
+#if !defined(WIN32) && !defined(GLEEM_NO_THREADS)
+// POSIX has no events; build one from a condition variable
+class PosixEvent
+{
+public:
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  bool signaled;
+};
+#endif
+
+Event::Event()
+{
+#if defined(WIN32)
+  // Auto-reset, initially not signaled
+  impl = CreateEvent(NULL, FALSE, FALSE, NULL);
+#elif !defined(GLEEM_NO_THREADS)
+  PosixEvent *event = new PosixEvent;
+  pthread_mutex_init(&event->mutex, NULL);
+  pthread_cond_init(&event->cond, NULL);
+  event->signaled = false;
+  impl = event;
+#else
+  impl = NULL;
+#endif
+}
+
+Event::~Event()
+{
+#if defined(WIN32)
+  CloseHandle((HANDLE) impl);
+#elif !defined(GLEEM_NO_THREADS)
+  PosixEvent *event = (PosixEvent *) impl;
+  pthread_cond_destroy(&event->cond);
+  pthread_mutex_destroy(&event->mutex);
+  delete event;
+#endif
+}
+
+void
+Event::set()
+{
+#if defined(WIN32)
+  SetEvent((HANDLE) impl);
+#elif !defined(GLEEM_NO_THREADS)
+  PosixEvent *event = (PosixEvent *) impl;
+  pthread_mutex_lock(&event->mutex);
+  event->signaled = true;
+  pthread_cond_signal(&event->cond);
+  pthread_mutex_unlock(&event->mutex);
+#endif
+}
+
+void
+Event::wait()
+{
+#if defined(WIN32)
+  WaitForSingleObject((HANDLE) impl, INFINITE);
+#elif !defined(GLEEM_NO_THREADS)
+  PosixEvent *event = (PosixEvent *) impl;
+  pthread_mutex_lock(&event->mutex);
+  while (!event->signaled)
+    pthread_cond_wait(&event->cond, &event->mutex);
+  event->signaled = false;
+  pthread_mutex_unlock(&event->mutex);
+#endif
+}
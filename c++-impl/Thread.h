@@ -0,0 +1,94 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_THREAD_H
+#define _GLEEM_THREAD_H
+
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+
+GLEEM_ENTER_NAMESPACE
+
+/** Minimal portable thread support: Win32 threads on Windows, POSIX
+    threads elsewhere. Compiling with GLEEM_NO_THREADS removes the
+    dependency on the threads library; gleem must then be used from a
+    single thread. */
+
+GLEEM_INTERNAL class GLEEMDLL Thread
+{
+public:
+  typedef unsigned long ID;
+  typedef void Function(void *arg);
+
+  /** Returns an identifier for the calling thread, unique among the
+      threads currently running */
+  static ID getCurrentID();
+
+  /** Starts a new thread running function(arg). The thread runs
+      until the function returns; nothing waits for it. Returns false
+      if the thread could not be created, or always when compiled with
+      GLEEM_NO_THREADS. */
+  static bool start(Function *function, void *arg);
+
+  /** A thread started by startJoinable() */
+  typedef void *Handle;
+
+  /** Like start(), but the thread must be waited for with join(),
+      which also frees its resources. Returns NULL if the thread could
+      not be created. */
+  static Handle startJoinable(Function *function, void *arg);
+
+  /** Waits for the thread to return from its function */
+  static void join(Handle thread);
+};
+
+/** A non-recursive mutual exclusion lock. With GLEEM_NO_THREADS its
+    operations do nothing. */
+
+GLEEM_INTERNAL class GLEEMDLL Mutex
+{
+public:
+  Mutex();
+  ~Mutex();
+
+  void lock();
+  void unlock();
+
+private:
+  // Not copyable
+  Mutex(const Mutex &);
+  Mutex &operator=(const Mutex &);
+
+  /** The platform's lock, allocated by the constructor */
+  void *impl;
+};
+
+/** An auto-reset event: set() wakes one thread blocked in wait(), or,
+    if none is, lets the next call to wait() return immediately. Any
+    number of calls to set() before a wait() count as one. With
+    GLEEM_NO_THREADS wait() returns immediately. */
+
+GLEEM_INTERNAL class GLEEMDLL Event
+{
+public:
+  Event();
+  ~Event();
+
+  void set();
+  void wait();
+
+private:
+  // Not copyable
+  Event(const Event &);
+  Event &operator=(const Event &);
+
+  void *impl;
+};
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_THREAD_H
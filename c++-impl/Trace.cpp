@@ -0,0 +1,180 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifdef WIN32
+# include <windows.h>
+#else
+# include <unistd.h>
+# ifdef _POSIX_THREADS
+#  include <pthread.h>
+# endif
+#endif
+#include <stdio.h>
+#include <iostream.h>
+#include <gleem/Trace.h>
+#include <gleem/Atomic.h>
+
+GLEEM_USE_NAMESPACE
+
+// One slot of the ring buffer. seq is the index of the event stored
+// in the slot, or -1 while a writer is filling it in or if the slot
+// has never been written.
+class TraceEvent
+{
+public:
+  TraceEvent();
+
+  volatile long seq;
+  const char *name;
+  const void *object;
+  unsigned long threadID;
+  GleemInt64 startNanos;
+  GleemInt64 endNanos;
+};
+
+TraceEvent::TraceEvent()
+{
+  seq = -1;
+  name = NULL;
+  object = NULL;
+  threadID = 0;
+  startNanos = 0;
+  endNanos = 0;
+}
+
+#ifdef GLEEM_ENABLE_TRACE
+static TraceEvent traceBuffer[Trace::BUFFER_SIZE];
+#endif
+// Index of the next event to be written; the slot used is this modulo
+// BUFFER_SIZE
+static volatile long nextTraceEvent = 0;
+
+static unsigned long
+currentThreadID()
+{
+#if defined(WIN32)
+  return (unsigned long) GetCurrentThreadId();
+#elif defined(_POSIX_THREADS)
+  return (unsigned long) pthread_self();
+#else
+  return 0;
+#endif
+}
+
+void
+Trace::record(const char *name, const void *object,
+	      GleemInt64 startNanos, GleemInt64 endNanos)
+{
+#ifdef GLEEM_ENABLE_TRACE
+  long index = Atomic::fetchAndAdd(&nextTraceEvent, 1);
+  TraceEvent &event =
+    traceBuffer[((unsigned long) index) % BUFFER_SIZE];
+  event.seq = -1;
+  Atomic::memoryBarrier();
+  event.name = name;
+  event.object = object;
+  event.threadID = currentThreadID();
+  event.startNanos = startNanos;
+  event.endNanos = endNanos;
+  Atomic::memoryBarrier();
+  event.seq = index;
+#endif
+}
+
+void
+Trace::clear()
+{
+#ifdef GLEEM_ENABLE_TRACE
+  // So that events from before the clear are not mistaken for the new
+  // ones which will reuse their slots
+  for (int i = 0; i < BUFFER_SIZE; i++)
+    traceBuffer[i].seq = -1;
+  Atomic::memoryBarrier();
+#endif
+  nextTraceEvent = 0;
+  Atomic::memoryBarrier();
+}
+
+int
+Trace::getNumEvents()
+{
+#ifdef GLEEM_ENABLE_TRACE
+  long num = nextTraceEvent;
+  return (num < BUFFER_SIZE) ? (int) num : BUFFER_SIZE;
+#else
+  return 0;
+#endif
+}
+
+bool
+Trace::writeChromeTrace(const char *fileName)
+{
+  FILE *file = fopen(fileName, "w");
+  if (file == NULL)
+    {
+      cerr << "gleem::Trace::writeChromeTrace: ERROR: can not open \""
+	   << fileName << "\"" << endl;
+      return false;
+    }
+  fprintf(file, "{\"traceEvents\":[");
+#ifdef GLEEM_ENABLE_TRACE
+  long end = nextTraceEvent;
+  long begin = (end > BUFFER_SIZE) ? (end - BUFFER_SIZE) : 0;
+  // Copy out the events first so that times can be made relative to
+  // the earliest one
+  TraceEvent *events = new TraceEvent[end - begin];
+  int numEvents = 0;
+  GleemInt64 origin = 0;
+  for (long i = begin; i < end; i++)
+    {
+      TraceEvent &slot = traceBuffer[((unsigned long) i) % BUFFER_SIZE];
+      if (slot.seq != i)
+	continue;
+      TraceEvent &event = events[numEvents];
+      event.name = slot.name;
+      event.object = slot.object;
+      event.threadID = slot.threadID;
+      event.startNanos = slot.startNanos;
+      event.endNanos = slot.endNanos;
+      Atomic::memoryBarrier();
+      // Skip events overwritten while being copied
+      if ((slot.seq != i) || (event.name == NULL))
+	continue;
+      if ((numEvents == 0) || (event.startNanos < origin))
+	origin = event.startNanos;
+      ++numEvents;
+    }
+  for (int j = 0; j < numEvents; j++)
+    {
+      const TraceEvent &event = events[j];
+      // Times are in microseconds
+      fprintf(file,
+	      "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,"
+	      "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"object\":\"%p\"}}",
+	      (j > 0) ? "," : "",
+	      event.name, event.threadID,
+	      (double) (event.startNanos - origin) / 1000.0,
+	      (double) (event.endNanos - event.startNanos) / 1000.0,
+	      event.object);
+    }
+  delete[] events;
+#endif
+  fprintf(file, "\n],\"displayTimeUnit\":\"ns\"}\n");
+  fclose(file);
+  return true;
+}
+
+TraceScope::TraceScope(const char *name, const void *object)
+{
+  this->name = name;
+  this->object = object;
+  start = Clock::nanoTime();
+}
+
+TraceScope::~TraceScope()
+{
+  Trace::record(name, object, start, Clock::nanoTime());
+}
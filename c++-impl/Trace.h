@@ -0,0 +1,79 @@
+/*
+ * gleem -- OpenGL Extremely Easy-To-Use Manipulators.
+ * Copyright (C) 1998 Kenneth B. Russell (kbrussel@media.mit.edu)
+ * See the file LICENSE.txt in the doc/ directory for licensing terms.
+ */
+
+#ifndef _GLEEM_TRACE_H
+#define _GLEEM_TRACE_H
+
+#include <gleem/Namespace.h>
+#include <gleem/GleemDLL.h>
+#include <gleem/Util.h>
+#include <gleem/Clock.h>
+
+GLEEM_ENTER_NAMESPACE
+
+/** Scoped trace events for profiling gleem's internals. If gleem is
+    compiled with GLEEM_ENABLE_TRACE defined (see TRACE_SWITCH in the
+    Makefile), rendering, picking, dragging and geometry updates each
+    record the time they started and how long they took, along with
+    the object involved, into a fixed-size ring buffer. The buffer
+    keeps the most recent events and can be written out at any time in
+    the Chrome trace event JSON format, which chrome://tracing and
+    Perfetto can display.
+
+    Recording is lock-free: each event claims a slot with a single
+    atomic increment, so events may be recorded from several threads
+    at once. Without GLEEM_ENABLE_TRACE the GLEEM_TRACE_SCOPE macro
+    compiles to nothing and the buffer is empty. */
+
+class GLEEMDLL Trace
+{
+public:
+  /** Number of events retained; older events are overwritten */
+  enum { BUFFER_SIZE = 32768 };
+
+  /** Adds an event to the ring buffer. name must be a string which
+      lives forever (typically a literal); object may be NULL. */
+  static void record(const char *name, const void *object,
+		     GleemInt64 startNanos, GleemInt64 endNanos);
+
+  /** Discards all recorded events */
+  static void clear();
+
+  /** Number of events currently in the buffer */
+  static int getNumEvents();
+
+  /** Writes the buffered events to the named file in the Chrome
+      trace event format. Events still being written by other threads
+      are skipped. Returns false and prints an error if the file could
+      not be created. */
+  static bool writeChromeTrace(const char *fileName);
+};
+
+/** Records a trace event covering its own lifetime. Used by
+    GLEEM_TRACE_SCOPE. */
+
+GLEEM_INTERNAL class GLEEMDLL TraceScope
+{
+public:
+  TraceScope(const char *name, const void *object);
+  ~TraceScope();
+
+private:
+  const char *name;
+  const void *object;
+  GleemInt64 start;
+};
+
+#ifdef GLEEM_ENABLE_TRACE
+# define GLEEM_TRACE_SCOPE(name, object) \
+  TraceScope _gleemTraceScope(name, object)
+#else
+# define GLEEM_TRACE_SCOPE(name, object)
+#endif
+
+GLEEM_EXIT_NAMESPACE
+
+#endif  // #defined _GLEEM_TRACE_H
@@ -6,14 +6,17 @@
 
 #include <gleem/Translate1Manip.h>
 #include <gleem/ManipPartTwoWayArrow.h>
+#include <gleem/ManipPartTable.h>
 #include <gleem/MathUtil.h>
+#include <gleem/Trace.h>
 
 GLEEM_USE_NAMESPACE
 
 Translate1Manip::Translate1Manip()
 {
-  geometry = new ManipPartTwoWayArrow(this);
+  geometry = new (getPartArena()) ManipPartTwoWayArrow(this);
   iOwnGeometry = true;
+  getPartTable()->addPickRoot(geometry);
   translation.setValue(0, 0, 0);
   axis.setValue(1, 0, 0);
   scale.setValue(1, 1, 1);
@@ -71,14 +74,17 @@ Translate1Manip::replaceGeometry(ManipPart *newGeom)
   if (iOwnGeometry)
     {
       delete geometry;
+      resetPartArena();
       iOwnGeometry = false;
     }
   geometry = newGeom;
   if (geometry == NULL)
     {
-      geometry = new ManipPartTwoWayArrow(this);
+      geometry = new (getPartArena()) ManipPartTwoWayArrow(this);
       iOwnGeometry = true;
     }
+  getPartTable()->clear();
+  getPartTable()->addPickRoot(geometry);
   recalc();
 }
 
@@ -151,9 +157,30 @@ Translate1Manip::makeInactive()
   geometry->clearHighlight();
 }
 
+bool
+Translate1Manip::getBoundingSphere(BSphere &bsph)
+{
+  return geometry->getBoundingSphere(bsph);
+}
+
+bool
+Translate1Manip::intersectFrustum(const Frustum &frustum)
+{
+  return geometry->intersectFrustum(frustum);
+}
+
+void
+Translate1Manip::getState(ManipState &state) const
+{
+  state.translation = translation;
+  state.scale = scale;
+}
+
 void
 Translate1Manip::recalc()
 {
+  GLEEM_TRACE_SCOPE("Translate1Manip::recalc", this);
+  placementChanged();
   // Construct local to world transform for geometry.
   // Scale, Rotation, Translation. Since we're right multiplying
   // column vectors, the actual matrix composed is TRS.
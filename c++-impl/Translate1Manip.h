@@ -63,6 +63,9 @@ GLEEM_INTERNAL public:
   virtual void drag(const GleemV3f &rayStart,
 		    const GleemV3f &rayDirection);
   virtual void makeInactive();
+  virtual bool getBoundingSphere(BSphere &bsph);
+  virtual bool intersectFrustum(const Frustum &frustum);
+  virtual void getState(ManipState &state) const;
 
 private:
   void recalc();
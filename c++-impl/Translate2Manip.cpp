@@ -7,7 +7,9 @@
 #include <gleem/Translate2Manip.h>
 #include <gleem/ManipPartTwoWayArrow.h>
 #include <gleem/ManipPartTransform.h>
+#include <gleem/ManipPartTable.h>
 #include <gleem/MathUtil.h>
+#include <gleem/Trace.h>
 
 GLEEM_USE_NAMESPACE
 
@@ -17,6 +19,7 @@ Translate2Manip::Translate2Manip()
   normal.setValue(0, 1, 0);
   scale.setValue(1, 1, 1);
   createGeometry();
+  getPartTable()->addPickRoot(geometry);
   recalc();
 }
 
@@ -70,18 +73,25 @@ Translate2Manip::replaceGeometry(ManipPart *newGeom)
   if (iOwnGeometry)
     {
       delete geometry;
+      resetPartArena();
       iOwnGeometry = false;
     }
   geometry = newGeom;
   if (geometry == NULL)
     createGeometry();
+  getPartTable()->clear();
+  getPartTable()->addPickRoot(geometry);
   recalc();
 }
 
 void
 Translate2Manip::render()
 {
-  geometry->render();
+  ManipPartTable *table = getActivePartTable();
+  if (table != NULL)
+    table->render();
+  else
+    geometry->render();
 }
 
 void
@@ -147,10 +157,11 @@ Translate2Manip::makeInactive()
 void
 Translate2Manip::createGeometry()
 {
-  ManipPartGroup *group = new ManipPartGroup(this);
-  ManipPartTwoWayArrow *arrow1 = new ManipPartTwoWayArrow(this);
+  ManipPartArena *arena = getPartArena();
+  ManipPartGroup *group = new (arena) ManipPartGroup(this);
+  ManipPartTwoWayArrow *arrow1 = new (arena) ManipPartTwoWayArrow(this);
   group->addPart(arrow1);
-  ManipPartTransform *xform = new ManipPartTransform(this);
+  ManipPartTransform *xform = new (arena) ManipPartTransform(this);
   GleemMat4f rotMat;
   rotMat.makeIdent();
   rotMat[0][0] = 0;
@@ -160,16 +171,37 @@ Translate2Manip::createGeometry()
   rotMat[1][2] = 0;
   rotMat[2][2] = 0;
   xform->setOffsetTransform(rotMat);
-  ManipPartTwoWayArrow *arrow2 = new ManipPartTwoWayArrow(this);
+  ManipPartTwoWayArrow *arrow2 = new (arena) ManipPartTwoWayArrow(this);
   xform->addPart(arrow2);
   group->addPart(xform);
   geometry = group;
   iOwnGeometry = true;
 }
 
+bool
+Translate2Manip::getBoundingSphere(BSphere &bsph)
+{
+  return geometry->getBoundingSphere(bsph);
+}
+
+bool
+Translate2Manip::intersectFrustum(const Frustum &frustum)
+{
+  return geometry->intersectFrustum(frustum);
+}
+
+void
+Translate2Manip::getState(ManipState &state) const
+{
+  state.translation = translation;
+  state.scale = scale;
+}
+
 void
 Translate2Manip::recalc()
 {
+  GLEEM_TRACE_SCOPE("Translate2Manip::recalc", this);
+  placementChanged();
   // Construct local to world transform for geometry.
   // Scale, Rotation, Translation. Since we're right multiplying
   // column vectors, the actual matrix composed is TRS.
@@ -204,5 +236,9 @@ Translate2Manip::recalc()
   xlateMat[2][3] = translation[2];
   GleemMat4f::mult(xlateMat, rotMat, tmpMat);
   GleemMat4f::mult(tmpMat, scaleMat, xform);
-  geometry->setTransform(xform);
+  ManipPartTable *table = getActivePartTable();
+  if (table != NULL)
+    table->setTransform(xform);
+  else
+    geometry->setTransform(xform);
 }
@@ -8,6 +8,9 @@
 #include <math.h>
 #include <gleem/_Linalg.h>
 #include <memory.h>
+#ifdef GLEEM_USE_SSE
+# include <xmmintrin.h>
+#endif
 
 // Can you believe Microsoft?
 #ifndef M_PI
@@ -18,8 +21,16 @@
 // _GleemV3f
 //
 
+// Fails to compile if a _GleemV3f can not be overlaid on a row of a
+// table declared with GLEEM_V3F_STRIDE (see _Linalg.h)
+typedef char _GleemV3fStrideCheck[(sizeof(_GleemV3f) ==
+				   GLEEM_V3F_STRIDE * sizeof(float)) ? 1 : -1];
+
 _GleemV3f::_GleemV3f()
 {
+#ifdef GLEEM_USE_SSE
+  val[3] = 0;
+#endif
 }
 
 _GleemV3f::_GleemV3f(const _GleemV3f &arg)
@@ -30,6 +41,9 @@ _GleemV3f::_GleemV3f(const _GleemV3f &arg)
 _GleemV3f::_GleemV3f(float x, float y, float z)
 {
   val[0] = x; val[1] = y; val[2] = z; 
+#ifdef GLEEM_USE_SSE
+  val[3] = 0;
+#endif
 }
 
 _GleemV3f &
@@ -67,7 +81,13 @@ _GleemV3f::setValue(float x, float y, float z)
 void
 _GleemV3f::setValue(const _GleemV3f &arg)
 {
+#ifdef GLEEM_USE_SSE
+  // Copying all four lanes at once keeps later vector loads of this
+  // vector from stalling on three separate scalar stores
+  _mm_storeu_ps(val, _mm_loadu_ps(arg.val));
+#else
   val[0] = arg.val[0]; val[1] = arg.val[1]; val[2] = arg.val[2];
+#endif
 }
 
 const float *
@@ -79,7 +99,18 @@ _GleemV3f::getValue() const
 float
 _GleemV3f::dot(const _GleemV3f &arg) const
 {
+#ifdef GLEEM_USE_SSE
+  // Sum only the first three products; the fourth lane is padding
+  __m128 prod = _mm_mul_ps(_mm_loadu_ps(val), _mm_loadu_ps(arg.val));
+  __m128 sum = _mm_add_ss(prod, _mm_shuffle_ps(prod, prod,
+					       _MM_SHUFFLE(1, 1, 1, 1)));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(prod, prod, _MM_SHUFFLE(2, 2, 2, 2)));
+  float result;
+  _mm_store_ss(&result, sum);
+  return result;
+#else
   return val[0] * arg.val[0] + val[1] * arg.val[1] + val[2] * arg.val[2];
+#endif
 }
 
 float
@@ -99,7 +130,14 @@ _GleemV3f::normalize()
 {
   float len = sqrtf(this->dot(*this));
   if (len != 0.0f)
-    _GleemV3f::scale(*this, 1.0f / len, *this);
+    {
+#ifdef GLEEM_USE_SSE
+      __m128 s = _mm_set1_ps(1.0f / len);
+      _mm_storeu_ps(val, _mm_mul_ps(_mm_loadu_ps(val), s));
+#else
+      _GleemV3f::scale(*this, 1.0f / len, *this);
+#endif
+    }
 }
 
 _GleemV3f
@@ -191,9 +229,22 @@ _GleemV3f::scale(const _GleemV3f &a, float s, _GleemV3f &c)
 void
 _GleemV3f::cross(const _GleemV3f &a, const _GleemV3f &b, _GleemV3f &c)
 {
+#ifdef GLEEM_USE_SSE
+  // (a.y b.z - a.z b.y, a.z b.x - a.x b.z, a.x b.y - a.y b.x); the
+  // padding lane works out to zero
+  __m128 va = _mm_loadu_ps(a.val);
+  __m128 vb = _mm_loadu_ps(b.val);
+  __m128 aYZX = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 0, 2, 1));
+  __m128 bYZX = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 0, 2, 1));
+  __m128 aZXY = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 1, 0, 2));
+  __m128 bZXY = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 1, 0, 2));
+  _mm_storeu_ps(c.val, _mm_sub_ps(_mm_mul_ps(aYZX, bZXY),
+				  _mm_mul_ps(aZXY, bYZX)));
+#else
   c.val[0] = a.val[1] * b.val[2] - b.val[1] * a.val[2];
   c.val[1] = b.val[0] * a.val[2] - a.val[0] * b.val[2];
   c.val[2] = a.val[0] * b.val[1] - b.val[0] * a.val[1];
+#endif
 }
 
 ostream &
@@ -437,9 +488,143 @@ _GleemMat4f::invertRigid()
   m[2][3] = trans[2];
 }
 
+// The rows of the inverse transpose of the upper left 3x3 of M are
+// the cross products of pairs of its rows, divided by the
+// determinant. Computes them into ADJ (last column zero) and returns
+// false if the matrix is singular.
+static bool
+invTransposeRows(const float m[4][4], float adj[3][4])
+{
+#ifdef GLEEM_USE_SSE
+  // The padding lane holds the translation, which cancels exactly in
+  // each cross product
+  __m128 r0 = _mm_loadu_ps(m[0]);
+  __m128 r1 = _mm_loadu_ps(m[1]);
+  __m128 r2 = _mm_loadu_ps(m[2]);
+  __m128 r0YZX = _mm_shuffle_ps(r0, r0, _MM_SHUFFLE(3, 0, 2, 1));
+  __m128 r1YZX = _mm_shuffle_ps(r1, r1, _MM_SHUFFLE(3, 0, 2, 1));
+  __m128 r2YZX = _mm_shuffle_ps(r2, r2, _MM_SHUFFLE(3, 0, 2, 1));
+  __m128 r0ZXY = _mm_shuffle_ps(r0, r0, _MM_SHUFFLE(3, 1, 0, 2));
+  __m128 r1ZXY = _mm_shuffle_ps(r1, r1, _MM_SHUFFLE(3, 1, 0, 2));
+  __m128 r2ZXY = _mm_shuffle_ps(r2, r2, _MM_SHUFFLE(3, 1, 0, 2));
+  __m128 c0 = _mm_sub_ps(_mm_mul_ps(r1YZX, r2ZXY), _mm_mul_ps(r1ZXY, r2YZX));
+  __m128 c1 = _mm_sub_ps(_mm_mul_ps(r2YZX, r0ZXY), _mm_mul_ps(r2ZXY, r0YZX));
+  __m128 c2 = _mm_sub_ps(_mm_mul_ps(r0YZX, r1ZXY), _mm_mul_ps(r0ZXY, r1YZX));
+  _mm_storeu_ps(adj[0], c0);
+  float det = m[0][0] * adj[0][0] + m[0][1] * adj[0][1] + m[0][2] * adj[0][2];
+  if (det == 0.0f)
+    return false;
+  __m128 invDet = _mm_set1_ps(1.0f / det);
+  _mm_storeu_ps(adj[0], _mm_mul_ps(c0, invDet));
+  _mm_storeu_ps(adj[1], _mm_mul_ps(c1, invDet));
+  _mm_storeu_ps(adj[2], _mm_mul_ps(c2, invDet));
+#else
+  adj[0][0] = m[1][1] * m[2][2] - m[2][1] * m[1][2];
+  adj[0][1] = m[2][0] * m[1][2] - m[1][0] * m[2][2];
+  adj[0][2] = m[1][0] * m[2][1] - m[2][0] * m[1][1];
+  float det = m[0][0] * adj[0][0] + m[0][1] * adj[0][1] + m[0][2] * adj[0][2];
+  if (det == 0.0f)
+    return false;
+  float invDet = 1.0f / det;
+  adj[0][0] *= invDet;
+  adj[0][1] *= invDet;
+  adj[0][2] *= invDet;
+  adj[1][0] = (m[2][1] * m[0][2] - m[0][1] * m[2][2]) * invDet;
+  adj[1][1] = (m[0][0] * m[2][2] - m[2][0] * m[0][2]) * invDet;
+  adj[1][2] = (m[2][0] * m[0][1] - m[0][0] * m[2][1]) * invDet;
+  adj[2][0] = (m[0][1] * m[1][2] - m[1][1] * m[0][2]) * invDet;
+  adj[2][1] = (m[1][0] * m[0][2] - m[0][0] * m[1][2]) * invDet;
+  adj[2][2] = (m[0][0] * m[1][1] - m[1][0] * m[0][1]) * invDet;
+  adj[0][3] = adj[1][3] = adj[2][3] = 0.0f;
+#endif
+  return true;
+}
+
+bool
+_GleemMat4f::invertAffine()
+{
+  float adj[3][4];
+  if (!invTransposeRows(m, adj))
+    return false;
+#ifdef GLEEM_USE_SSE
+  // Inverse is the transpose of ADJ. New translation is -(inverse *
+  // translation), which is a linear combination of the rows of ADJ;
+  // transposing it in as the fourth row drops it into the last column
+  __m128 c0 = _mm_loadu_ps(adj[0]);
+  __m128 c1 = _mm_loadu_ps(adj[1]);
+  __m128 c2 = _mm_loadu_ps(adj[2]);
+  __m128 trans = _mm_mul_ps(c0, _mm_set1_ps(m[0][3]));
+  trans = _mm_add_ps(trans, _mm_mul_ps(c1, _mm_set1_ps(m[1][3])));
+  trans = _mm_add_ps(trans, _mm_mul_ps(c2, _mm_set1_ps(m[2][3])));
+  trans = _mm_sub_ps(_mm_setzero_ps(), trans);
+  _MM_TRANSPOSE4_PS(c0, c1, c2, trans);
+  _mm_storeu_ps(m[0], c0);
+  _mm_storeu_ps(m[1], c1);
+  _mm_storeu_ps(m[2], c2);
+#else
+  float t0 = m[0][3];
+  float t1 = m[1][3];
+  float t2 = m[2][3];
+  for (int i = 0; i < 3; i++)
+    {
+      m[i][0] = adj[0][i];
+      m[i][1] = adj[1][i];
+      m[i][2] = adj[2][i];
+      m[i][3] = -(adj[0][i] * t0 + adj[1][i] * t1 + adj[2][i] * t2);
+    }
+#endif
+  m[3][0] = m[3][1] = m[3][2] = 0.0f;
+  m[3][3] = 1.0f;
+  return true;
+}
+
+bool
+_GleemMat4f::getNormalMatrix(_GleemMat4f &dest) const
+{
+  float adj[3][4];
+  if (!invTransposeRows(m, adj))
+    return false;
+  for (int i = 0; i < 3; i++)
+    {
+      dest.m[i][0] = adj[i][0];
+      dest.m[i][1] = adj[i][1];
+      dest.m[i][2] = adj[i][2];
+      dest.m[i][3] = 0.0f;
+    }
+  dest.m[3][0] = dest.m[3][1] = dest.m[3][2] = 0.0f;
+  dest.m[3][3] = 1.0f;
+  return true;
+}
+
+bool
+_GleemMat4f::equalExceptTranslation(const _GleemMat4f &arg) const
+{
+  for (int rc = 0; rc < 4; rc++)
+    for (int cc = 0; cc < 3; cc++)
+      if (m[rc][cc] != arg.m[rc][cc])
+	return false;
+  return (m[3][3] == arg.m[3][3]);
+}
+
 void
 _GleemMat4f::mult(const _GleemMat4f &a, const _GleemMat4f &b, _GleemMat4f &c)
 {
+#ifdef GLEEM_USE_SSE
+  // Each row of C is a linear combination of the rows of B
+  __m128 b0 = _mm_loadu_ps(b.m[0]);
+  __m128 b1 = _mm_loadu_ps(b.m[1]);
+  __m128 b2 = _mm_loadu_ps(b.m[2]);
+  __m128 b3 = _mm_loadu_ps(b.m[3]);
+  for (int rc = 0; rc < 4; rc++)
+    {
+      const float *row = a.m[rc];
+      __m128 sum = _mm_mul_ps(_mm_set1_ps(row[0]), b0);
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(row[1]), b1));
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(row[2]), b2));
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(row[3]), b3));
+      _mm_storeu_ps(c.m[rc], sum);
+    }
+#else
   for (int rc = 0; rc < 4; rc++)
     for (int cc = 0; cc < 4; cc++)
       {
@@ -448,6 +633,45 @@ _GleemMat4f::mult(const _GleemMat4f &a, const _GleemMat4f &b, _GleemMat4f &c)
 	  tmp += a[rc][i] * b[i][cc];
 	c[rc][cc] = tmp;
       }
+#endif
+}
+
+void
+_GleemMat4f::multTranslation(const _GleemMat4f &a, const _GleemMat4f &b,
+			     _GleemMat4f &c)
+{
+  for (int rc = 0; rc < 3; rc++)
+    {
+      // Sum the terms in the same order as mult()
+#ifdef GLEEM_USE_SSE
+      float tmp = a[rc][0] * b[0][3];
+#else
+      float tmp = 0.0f;
+      tmp += a[rc][0] * b[0][3];
+#endif
+      tmp += a[rc][1] * b[1][3];
+      tmp += a[rc][2] * b[2][3];
+      tmp += a[rc][3] * b[3][3];
+      c[rc][3] = tmp;
+    }
+}
+
+void
+_GleemMat4f::invertAffineTranslation(const _GleemMat4f &a, _GleemMat4f &inv)
+{
+  float t0 = a[0][3];
+  float t1 = a[1][3];
+  float t2 = a[2][3];
+  for (int i = 0; i < 3; i++)
+    {
+      // Sum the terms in the same order as invertAffine()
+      float tmp = inv[i][0] * t0 + inv[i][1] * t1 + inv[i][2] * t2;
+#ifdef GLEEM_USE_SSE
+      inv[i][3] = 0.0f - tmp;
+#else
+      inv[i][3] = -tmp;
+#endif
+    }
 }
 
 void
@@ -841,6 +1065,33 @@ _GleemRot::normalize()
 void
 _GleemRot::mult(const _GleemRot &a, const _GleemRot &b, _GleemRot &c)
 {
+#ifdef GLEEM_USE_SSE
+  // The terms of each lane are summed in the same order as in the
+  // scalar code below, so that the results are identical:
+  // c = (a0, a0, a0, a0) * ( b0,  b1,  b2,  b3)
+  //   + (a1, a1, a2, a3) * (-b1,  b0,  b0,  b0)
+  //   + (a2, a2, a1, a1) * (-b2,  b3, -b3,  b2)
+  //   + (a3, a3, a3, a2) * (-b3, -b2,  b1, -b1)
+  __m128 va = _mm_loadu_ps(a.val);
+  __m128 vb = _mm_loadu_ps(b.val);
+  __m128 b1 = _mm_mul_ps(_mm_shuffle_ps(vb, vb, _MM_SHUFFLE(0, 0, 0, 1)),
+			 _mm_set_ps(1.0f, 1.0f, 1.0f, -1.0f));
+  __m128 b2 = _mm_mul_ps(_mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 3, 3, 2)),
+			 _mm_set_ps(1.0f, -1.0f, 1.0f, -1.0f));
+  __m128 b3 = _mm_mul_ps(_mm_shuffle_ps(vb, vb, _MM_SHUFFLE(1, 1, 2, 3)),
+			 _mm_set_ps(-1.0f, 1.0f, -1.0f, -1.0f));
+  __m128 sum = _mm_mul_ps(_mm_set1_ps(a.val[0]), vb);
+  sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(va, va,
+						  _MM_SHUFFLE(3, 2, 1, 1)),
+				   b1));
+  sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(va, va,
+						  _MM_SHUFFLE(1, 1, 2, 2)),
+				   b2));
+  sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(va, va,
+						  _MM_SHUFFLE(2, 3, 3, 3)),
+				   b3));
+  _mm_storeu_ps(c.val, sum);
+#else
   c.val[0] = (a.val[0] * b.val[0] - a.val[1] * b.val[1] -
 	      a.val[2] * b.val[2] - a.val[3] * b.val[3]);
   c.val[1] = (a.val[0] * b.val[1] + a.val[1] * b.val[0] +
@@ -849,6 +1100,7 @@ _GleemRot::mult(const _GleemRot &a, const _GleemRot &b, _GleemRot &c)
 	      a.val[1] * b.val[3] + a.val[3] * b.val[1]);
   c.val[3] = (a.val[0] * b.val[3] + a.val[3] * b.val[0] +
 	      a.val[1] * b.val[2] - a.val[2] * b.val[1]);
+#endif
 }
 
 _GleemRot
@@ -931,45 +1183,48 @@ _GleemRot::fromMatrix(const _GleemMat4f &mat)
 
 /** Implementation is from Horn's _Robot Vision_ */
 
+// For unit quaternion q = (w, u), the rotation of v is
+//
+//   v' = v + w t + u x t,  where t = 2 (u x v)
+//
+// which is algebraically the same as the vector part of q v q^-1 but
+// takes only two cross products and never touches *this.
+
 void
-_GleemRot::rotateVector(const _GleemV3f &src, _GleemV3f &dest)
+_GleemRot::rotateVector(const _GleemV3f &src, _GleemV3f &dest) const
 {
-  _GleemV3f qCrossX;
-  _GleemV3f qCrossXCrossQ;
-  _GleemV3f qVec(val[1], val[2], val[3]);
-  
-  _GleemV3f::cross(qVec, src, qCrossX);
-  _GleemV3f::cross(qCrossX, qVec, qCrossXCrossQ);
-  _GleemV3f::scale(qCrossX, 2.0f * val[0], qCrossX);
-  _GleemV3f::scale(qCrossXCrossQ, -2.0f, qCrossXCrossQ);
-  _GleemV3f::add(src, qCrossX, dest);
-  _GleemV3f::add(dest, qCrossXCrossQ, dest);
-
-  /*
-  _GleemRot tmp, tmp2;
-  _GleemRot x;
-  x.val[0] = 0;
-  x.val[1] = src[0];
-  x.val[2] = src[1];
-  x.val[3] = src[2];
-  mult(*this, x, tmp);
-  invert();
-  mult(tmp, *this, tmp2);
-  invert();
-  dest[0] = tmp2.val[1];
-  dest[1] = tmp2.val[2];
-  dest[2] = tmp2.val[3];
-  */
+  rotateVectors(1, &src, &dest);
 }
 
 _GleemV3f
-_GleemRot::rotateVector(const _GleemV3f &src)
+_GleemRot::rotateVector(const _GleemV3f &src) const
 {
   _GleemV3f dest;
-  rotateVector(src, dest);
+  rotateVectors(1, &src, &dest);
   return dest;
 }
 
+void
+_GleemRot::rotateVectors(int num, const _GleemV3f *src, _GleemV3f *dest) const
+{
+  float w = val[0];
+  float ux = val[1];
+  float uy = val[2];
+  float uz = val[3];
+  for (int i = 0; i < num; i++)
+    {
+      float vx = src[i].val[0];
+      float vy = src[i].val[1];
+      float vz = src[i].val[2];
+      float tx = 2.0f * (uy * vz - uz * vy);
+      float ty = 2.0f * (uz * vx - ux * vz);
+      float tz = 2.0f * (ux * vy - uy * vx);
+      dest[i].val[0] = vx + w * tx + (uy * tz - uz * ty);
+      dest[i].val[1] = vy + w * ty + (uz * tx - ux * tz);
+      dest[i].val[2] = vz + w * tz + (ux * ty - uy * tx);
+    }
+}
+
 ostream &
 operator<<(ostream &os, const _GleemRot &vec)
 {
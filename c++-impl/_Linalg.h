@@ -18,6 +18,24 @@ class _GleemMat4f;
 // intended to be. I would discourage users from applying this code
 // outside this library; most of it is straightforward, but parts like
 // the matrix inverses are almost guaranteed to be poorly conditioned.
+//
+// If GLEEM_USE_SSE is defined (see LINALG_SWITCH in the Makefile) the
+// vector dot and cross products, normalization, 4x4 matrix multiply
+// and quaternion multiply are implemented with SSE intrinsics. The
+// interface is the same either way, but _GleemV3f is padded to four
+// floats so that whole vectors can be loaded and stored at once. The
+// SSE code uses unaligned loads and stores, since neither the
+// compilers nor the STL allocators we support can guarantee 16-byte
+// alignment.
+//
+// Since the padding changes the layout of every structure holding a
+// vector (CameraParameters, HitPoint, ManipState, ...), the class
+// also gets a different name, so that an application compiled without
+// GLEEM_USE_SSE fails to link against an SSE build of gleem, and vice
+// versa, instead of silently disagreeing about those layouts.
+#ifdef GLEEM_USE_SSE
+# define _GleemV3f _GleemV3fSSE
+#endif
 
 /** 3-element vector. */
 
@@ -76,9 +94,32 @@ public:
   friend ostream &operator<<(ostream &os, const _GleemV3f &vec);
 
 private:
+  // For fast access in _GleemRot::rotateVectors()
+  friend class _GleemRot;
+
+#ifdef GLEEM_USE_SSE
+  // The fourth element is padding. The constructors zero it so that
+  // the SSE code never operates on a denormal or NaN left in it.
+  float val[4];
+#else
   float val[3];
+#endif
 };
 
+// Static tables of vertices which need to be used as arrays of
+// _GleemV3f can be declared as "const float table[][GLEEM_V3F_STRIDE]"
+// with each entry written as GLEEM_V3F_INIT(x, y, z). They are then
+// initialized at compile time (no constructors run, so there is no
+// initialization order problem) and can be cast to const _GleemV3f *.
+
+#ifdef GLEEM_USE_SSE
+# define GLEEM_V3F_STRIDE 4
+# define GLEEM_V3F_INIT(x, y, z) { x, y, z, 0 }
+#else
+# define GLEEM_V3F_STRIDE 3
+# define GLEEM_V3F_INIT(x, y, z) { x, y, z }
+#endif
+
 /** 2-element vector */
 
 class GLEEMDLL _GleemV2f {
@@ -167,8 +208,40 @@ public:
       upper left 3x3; negates translation in rightmost column and
       transforms by inverted rotation. */
   void invertRigid();
+  /** Inverts this matrix assuming that it represents an affine
+      transform (i.e., the bottom row is 0 0 0 1), which may include
+      non-uniform scales and shears. Algorithm: inverts upper left 3x3
+      using cross products of its rows; transforms negated translation
+      by the result. Returns false and leaves the matrix untouched if
+      the upper left 3x3 is singular. */
+  bool invertAffine();
+  /** Computes the inverse transpose of the upper left 3x3 of this
+      matrix, which is the transform to apply to surface normals when
+      there are non-uniform scales. The result is placed in the upper
+      left 3x3 of DEST; the rest of DEST is set to the identity.
+      Returns false and leaves DEST untouched if the upper left 3x3 is
+      singular. */
+  bool getNormalMatrix(_GleemMat4f &dest) const;
+  /** Returns true if this matrix and ARG are equal except possibly
+      in their translation components */
+  bool equalExceptTranslation(const _GleemMat4f &arg) const;
   /** C = A * B. NOTE: CAN NOT USE A SRC FOR THE DEST. */
   static void mult(const _GleemMat4f &a, const _GleemMat4f &b, _GleemMat4f &c);
+  /** Computes only the translation component of C = A * B, with the
+      same results as mult(), leaving the rest of C untouched. If B is
+      affine and A has changed only in translation since C was last
+      computed, this brings C up to date (except possibly for the
+      signs of zero elements). NOTE: CAN NOT USE A SRC FOR THE DEST. */
+  static void multTranslation(const _GleemMat4f &a, const _GleemMat4f &b,
+			      _GleemMat4f &c);
+  /** Computes only the translation component of INV = inverse(A),
+      with the same results as invertAffine(), using the upper left
+      3x3 already in INV and leaving the rest of INV untouched. If A
+      has changed only in translation since INV was last computed,
+      this brings INV up to date (except possibly for the signs of
+      zero elements). NOTE: CAN NOT USE A SRC FOR THE DEST. */
+  static void invertAffineTranslation(const _GleemMat4f &a,
+				      _GleemMat4f &inv);
   /** NOTE: ignores homogeneous coordinate, i.e., is not a full
       transformation.  NOTE: CAN NOT USE SRC FOR DEST. */
   void xformPt(const _GleemV3f &src, _GleemV3f &dest) const;
@@ -326,12 +399,18 @@ public:
       See _GleemMat4f::getRotation(), above. */
   void fromMatrix(const _GleemMat4f &mat);
   
-  /** Rotate a vector by this quaternion. NOTE: CAN NOT USE SOURCE FOR
-      DEST. */
-  void rotateVector(const _GleemV3f &src, _GleemV3f &dest);
+  /** Rotate a vector by this quaternion. Does not modify this
+      quaternion, which must be a unit quaternion. Can use source for
+      dest. */
+  void rotateVector(const _GleemV3f &src, _GleemV3f &dest) const;
 
   /** Rotate a vector by this quaternion, returning result on stack. */
-  _GleemV3f rotateVector(const _GleemV3f &src);
+  _GleemV3f rotateVector(const _GleemV3f &src) const;
+
+  /** Rotate num vectors from src into dest. Equivalent to calling
+      rotateVector() on each, but computes the quaternion terms only
+      once. Can use source for dest. */
+  void rotateVectors(int num, const _GleemV3f *src, _GleemV3f *dest) const;
 
   /** Convenience operator. Puts quaternion on output stream looking
       like "[ q0, q1, q2, q3 ]". Note this does NOT correspond to the
@@ -97,6 +97,26 @@ PostBuild_Cmds=echo copy Debug\gleemdlld.lib ..\lib\nt	copy Debug\gleemdlld.lib
 # Name "gleemdll - Win32 Debug"
 # Begin Source File
 
+SOURCE=..\Atomic.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\Clock.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\EventLog.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\Frustum.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LatencyHistogram.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\_Linalg.cpp
 # End Source File
 # Begin Source File
@@ -121,6 +141,14 @@ SOURCE=..\Manip.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\ManipCallbackList.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\ManipCallbackWorker.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\ManipManager.cpp
 # End Source File
 # Begin Source File
@@ -129,6 +157,10 @@ SOURCE=..\ManipPart.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\ManipPartArena.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\ManipPartCube.cpp
 # End Source File
 # Begin Source File
@@ -145,10 +177,18 @@ SOURCE=..\ManipPartLineSeg.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\ManipPartMesh.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\ManipPartSquare.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\ManipPartTable.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\ManipPartTransform.cpp
 # End Source File
 # Begin Source File
@@ -161,6 +201,18 @@ SOURCE=..\ManipPartTwoWayArrow.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\ManipState.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\ManipStats.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\ManipTargets.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\MathUtil.cpp
 # End Source File
 # Begin Source File
@@ -169,6 +221,14 @@ SOURCE=..\NormalCalc.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\ObliqueTruncPyrMapping.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\OrthographicMapping.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\Plane.cpp
 # End Source File
 # Begin Source File
@@ -185,6 +245,26 @@ SOURCE=..\RightTruncPyrMapping.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\ScreenToRayBasis.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\ScreenToRayMapping.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\TaskPool.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\Thread.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\Trace.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\Translate1Manip.cpp
 # End Source File
 # Begin Source File